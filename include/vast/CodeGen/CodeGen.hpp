@@ -7,7 +7,6 @@
 VAST_RELAX_WARNINGS
 #include <clang/Frontend/ASTUnit.h>
 #include <mlir/IR/Verifier.h>
-#include <mlir/InitAllDialects.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/CodeGen/DefaultVisitor.hpp"
@@ -24,10 +23,7 @@ namespace vast::cg
 {
     namespace detail {
         static inline mcontext_t& codegen_context_setup(mcontext_t &ctx) {
-            mlir::registerAllDialects(ctx);
-            vast::registerAllDialects(ctx);
-
-            ctx.loadAllAvailableDialects();
+            vast::loadMinimalDialects(ctx);
             return ctx;
         }
     } // namespace detail
@@ -117,6 +117,7 @@ namespace vast::cg {
         using lens = visitor_lens< derived_t, builder_t >;
 
         using lens::mlir_builder;
+        using lens::context;
         using lens::acontext;
 
         using lens::visit;
@@ -345,6 +346,12 @@ namespace vast::cg {
         }
 
         mlir_value constant(loc_t loc, mlir_type ty, string_ref value) {
+            const auto &threshold = context().strlit_resource_threshold;
+            if (threshold && value.size() >= *threshold) {
+                auto attr = core::StringLiteralResourceAttr::get(ty, "vast_strlit", value);
+                return create< hl::ConstantOp >(loc, ty, attr);
+            }
+
             return create< hl::ConstantOp >(loc, ty, value);
         }
     };
@@ -81,6 +81,10 @@ namespace vast::cg
 
         dl::DataLayoutBlueprint dl;
 
+        // String literals of at least this size are stored in resource blobs
+        // instead of being uniqued in the context.
+        std::optional< std::size_t > strlit_resource_threshold;
+
         codegen_context(mcontext_t &mctx, acontext_t &actx, owning_module_ref &&mod)
             : mctx(mctx)
             , actx(actx)
@@ -7,6 +7,8 @@
 VAST_RELAX_WARNINGS
 #include <clang/AST/Decl.h>
 #include <clang/AST/GlobalDecl.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/STLFunctionalExtras.h>
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
@@ -14,6 +16,7 @@ VAST_UNRELAX_WARNINGS
 
 #include "vast/CodeGen/CodeGen.hpp"
 #include "vast/CodeGen/CodeGenTypeDriver.hpp"
+#include "vast/CodeGen/FunctionVerifier.hpp"
 
 #include "vast/Util/Common.hpp"
 #include "vast/Util/DataLayout.hpp"
@@ -40,6 +43,34 @@ namespace vast::cg
         ~defer_handle_of_top_level_decl();
     };
 
+    // Bodies of function definitions generated by earlier compilations.
+    //
+    // Locations of a body are identifiers of the range assigned while it was
+    // generated. A restored body reserves a range of the same size, so that
+    // its locations match the ones of a generated body.
+    //
+    struct function_body_cache {
+        using declare_function = llvm::function_ref< hl::FuncOp(const clang::FunctionDecl *) >;
+        using reserve_ids = llvm::function_ref< meta::identifier_t(meta::identifier_t) >;
+
+        virtual ~function_body_cache() = default;
+
+        // Fills the empty body of `fn` with the one generated for an identical
+        // definition. Functions the body refers to are declared by `declare`,
+        // identifiers of its locations are taken from `reserve`.
+        virtual bool restore(
+            hl::FuncOp fn, const clang::FunctionDecl *decl,
+            codegen_context &cgctx, declare_function declare, reserve_ids reserve
+        ) = 0;
+
+        // Records the body of `fn` generated in this compilation with location
+        // identifiers in [first, first + count).
+        virtual void record(
+            hl::FuncOp fn, const clang::FunctionDecl *decl,
+            meta::identifier_t first, meta::identifier_t count
+        ) = 0;
+    };
+
     using target_info_ptr = std::unique_ptr< target_info_t >;
 
     x86_avx_abi_level avx_level(const clang::TargetInfo &target);
@@ -60,6 +91,7 @@ namespace vast::cg
         )
             : actx(cgctx.actx)
             , mctx(cgctx.mctx)
+            , cgctx(cgctx)
             , opts(opts)
             , cxx_abi(create_cxx_abi(actx))
             , codegen(cgctx)
@@ -72,7 +104,9 @@ namespace vast::cg
         }
 
         ~codegen_driver() {
-            VAST_ASSERT(deferred_inline_member_func_defs.empty());
+            VAST_ASSERT(
+                deferred_inline_member_func_defs.empty() || opts.diags.hasErrorOccurred()
+            );
         }
 
         codegen_driver(const codegen_driver &) = delete;
@@ -83,9 +117,21 @@ namespace vast::cg
 
         bool verify_module() const;
 
+        // Verifies functions as their bodies are generated instead of along
+        // with the whole module in `verify_module`.
+        void enable_function_verifier();
+
         void handle_translation_unit(acontext_t &acontext);
         void handle_top_level_decl(clang::DeclGroupRef decls);
         void handle_top_level_decl(clang::Decl *decl);
+        void handle_inline_function_definition(clang::FunctionDecl *decl);
+        void handle_cxx_static_member_var_instantiation(clang::VarDecl *decl);
+
+        // Emits top-level declarations deserialized from precompiled headers
+        // and modules since the last call. Clang passes only the "interesting"
+        // ones to the consumer, and it may do so in the middle of generating
+        // another declaration.
+        void handle_external_decls();
 
         void finalize();
 
@@ -110,6 +156,8 @@ namespace vast::cg
 
         void dump_module() { codegen.dump_module(); }
 
+        void set_function_cache(function_body_cache *cache) { functions = cache; }
+
     private:
 
         bool should_emit_function(clang::GlobalDecl decl);
@@ -136,6 +184,7 @@ namespace vast::cg
 
         operation build_global_definition(clang::GlobalDecl decl);
         operation build_global_function_definition(clang::GlobalDecl decl);
+        bool restore_function_body(hl::FuncOp fn, const clang::FunctionDecl *decl);
         operation build_global_var_definition(const clang::VarDecl *decl, bool tentative = false);
 
         function_arg_list build_function_arg_list(clang::GlobalDecl decl);
@@ -180,6 +229,8 @@ namespace vast::cg
         void build_deferred_decls();
         void build_default_methods();
 
+        void build_external_decls();
+
         // FIXME: should we use llvm::TrackingVH<mlir::Operation> here?
         using replacements_map = llvm::StringMap< mlir::Operation * >;
         replacements_map replacements;
@@ -193,14 +244,24 @@ namespace vast::cg
 
         acontext_t &actx;
         mcontext_t &mctx;
+        codegen_context &cgctx;
 
         cc::action_options &opts;
 
+        function_body_cache *functions = nullptr;
+
+        std::unique_ptr< function_verifier > verifier;
+
         unsigned deferred_top_level_decls = 0;
 
         friend struct defer_handle_of_top_level_decl;
         llvm::SmallVector< clang::FunctionDecl *, 8 > deferred_inline_member_func_defs;
 
+        // Top-level declarations of precompiled headers and modules emitted
+        // so far.
+        llvm::DenseSet< const clang::Decl * > external_decls;
+        bool external_decls_visited = false;
+
         std::unique_ptr< vast_cxx_abi > cxx_abi;
 
         // FIXME: make configurable
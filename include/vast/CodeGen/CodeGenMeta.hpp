@@ -83,6 +83,17 @@ namespace vast::cg
         loc_t location(const clang::Type *type) const final { return location_impl(type); }
         loc_t location(clang::QualType type) const final { return location_impl(type); }
 
+        // Identifier of the next generated location.
+        meta::identifier_t next_id() const { return counter; }
+
+        // Skips `count` identifiers of locations created elsewhere (e.g.,
+        // restored from a cache) and returns the first of them.
+        meta::identifier_t reserve(meta::identifier_t count) const {
+            auto first = counter;
+            counter += count;
+            return first;
+        }
+
       private:
 
         loc_t make_location(meta::IdentifierAttr id) const {
@@ -40,6 +40,7 @@ namespace vast::cg {
         using lens::derived;
         using lens::context;
         using lens::mcontext;
+        using lens::acontext;
 
         using lens::visit;
         using lens::visit_as_lvalue_type;
@@ -1001,9 +1002,119 @@ namespace vast::cg {
         // operation VisitCompoundLiteralExpr(const clang::CompoundLiteralExpr *lit)
         // operation VisitFixedPointLiteral(const clang::FixedPointLiteral *lit)
 
+        // Initializer lists of constant scalars with at least this many
+        // elements are emitted as a single `hl.dense_initlist`.
+        static constexpr std::uint64_t dense_init_list_threshold = 16;
+
+        mlir_type dense_element_type(clang::QualType type) {
+            if (!type->isBuiltinType() || type->isBooleanType()) {
+                return {};
+            }
+
+            if (type->isIntegerType()) {
+                return mlir::IntegerType::get(&mcontext(), acontext().getTypeSize(type));
+            }
+
+            if (type->isRealFloatingType()) {
+                const auto &sem = acontext().getFloatTypeSemantics(type);
+                if (&sem == &llvm::APFloat::IEEEhalf())
+                    return mlir::Float16Type::get(&mcontext());
+                if (&sem == &llvm::APFloat::BFloat())
+                    return mlir::BFloat16Type::get(&mcontext());
+                if (&sem == &llvm::APFloat::IEEEsingle())
+                    return mlir::Float32Type::get(&mcontext());
+                if (&sem == &llvm::APFloat::IEEEdouble())
+                    return mlir::Float64Type::get(&mcontext());
+                if (&sem == &llvm::APFloat::x87DoubleExtended())
+                    return mlir::Float80Type::get(&mcontext());
+                if (&sem == &llvm::APFloat::IEEEquad())
+                    return mlir::Float128Type::get(&mcontext());
+            }
+
+            return {};
+        }
+
+        template< typename value_t >
+        std::optional< mlir::ElementsAttr > dense_init_list(
+            const clang::InitListExpr *expr, mlir::RankedTensorType type, value_t zero,
+            auto &&get
+        ) {
+            llvm::SmallVector< value_t > values;
+            values.reserve(type.getNumElements());
+
+            for (auto init : expr->inits()) {
+                clang::Expr::EvalResult result;
+                if (!init->EvaluateAsRValue(result, acontext()) || result.HasSideEffects) {
+                    return std::nullopt;
+                }
+
+                auto value = get(result.Val);
+                if (!value) {
+                    return std::nullopt;
+                }
+
+                values.push_back(std::move(*value));
+            }
+
+            values.resize(type.getNumElements(), zero);
+            return mlir::cast< mlir::ElementsAttr >(mlir::DenseElementsAttr::get(type, values));
+        }
+
+        // Returns elements of an initializer list of constant scalars, that
+        // is large enough to be stored densely.
+        std::optional< mlir::ElementsAttr > dense_init_list(const clang::InitListExpr *expr) {
+            auto array = acontext().getAsConstantArrayType(expr->getType());
+            if (!array) {
+                return std::nullopt;
+            }
+
+            auto size = array->getSize().getZExtValue();
+            if (size < dense_init_list_threshold || expr->getNumInits() > size) {
+                return std::nullopt;
+            }
+
+            // only implicit zero initialization of the trailing elements
+            if (expr->hasArrayFiller()
+                && !clang::isa< clang::ImplicitValueInitExpr >(expr->getArrayFiller())
+            ) {
+                return std::nullopt;
+            }
+
+            auto element_type = dense_element_type(array->getElementType());
+            if (!element_type) {
+                return std::nullopt;
+            }
+
+            auto type = mlir::RankedTensorType::get({ std::int64_t(size) }, element_type);
+
+            if (auto int_type = mlir::dyn_cast< mlir::IntegerType >(element_type)) {
+                auto bits = int_type.getWidth();
+                return dense_init_list(expr, type, llvm::APInt(bits, 0),
+                    [bits] (const clang::APValue &value) -> std::optional< llvm::APInt > {
+                        if (!value.isInt())
+                            return std::nullopt;
+                        return value.getInt().extOrTrunc(bits);
+                    }
+                );
+            }
+
+            auto float_type = mlir::cast< mlir::FloatType >(element_type);
+            return dense_init_list(expr, type, llvm::APFloat::getZero(float_type.getFloatSemantics()),
+                [] (const clang::APValue &value) -> std::optional< llvm::APFloat > {
+                    if (!value.isFloat())
+                        return std::nullopt;
+                    return value.getFloat();
+                }
+            );
+        }
+
         operation VisitInitListExpr(const clang::InitListExpr *expr) {
             auto ty = visit(expr->getType());
 
+            if (auto dense = dense_init_list(expr)) {
+                return make< hl::DenseInitListExpr >(meta_location(expr), ty, *dense);
+            }
+
             llvm::SmallVector< Value > elements;
             for (auto elem : expr->inits()) {
                 elements.push_back(visit(elem)->getResult(0));
@@ -0,0 +1,59 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/Support/ThreadPool.h>
+#include <mlir/IR/Diagnostics.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Util/Common.hpp"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+namespace vast::cg {
+
+    //
+    // Verifies functions as soon as their bodies are generated. Verification
+    // runs on the thread pool of the context while codegen continues, so a
+    // function must not change once it is handed over. Without threading,
+    // functions are verified right away.
+    //
+    // Diagnostics of concurrent verifications are held back and emitted in
+    // the order of the functions when they are awaited, each failure followed
+    // by the name of the function.
+    //
+    struct function_verifier {
+        explicit function_verifier(mcontext_t &mctx);
+        ~function_verifier();
+
+        function_verifier(const function_verifier &) = delete;
+        function_verifier &operator=(const function_verifier &) = delete;
+
+        void verify(hl::FuncOp fn);
+
+        // Waits for pending verifications, returns false if any function
+        // failed so far.
+        bool wait();
+
+        // Whether `op` is a function handed over for verification.
+        bool covers(operation op) const { return functions.contains(op); }
+
+      private:
+        mcontext_t &mctx;
+
+        std::optional< mlir::ParallelDiagnosticHandler > diagnostics;
+        std::unique_ptr< llvm::ThreadPoolTaskGroup > tasks;
+        std::size_t order = 0;
+
+        llvm::DenseSet< operation > functions;
+        std::atomic< bool > failed = false;
+    };
+
+} // namespace vast::cg
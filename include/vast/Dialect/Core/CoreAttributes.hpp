@@ -22,7 +22,8 @@ VAST_UNRELAX_WARNINGS
 namespace vast::core {
 
     using typed_attrs = util::type_list<
-        BooleanAttr, IntegerAttr, FloatAttr, StringLiteralAttr, VoidAttr
+        BooleanAttr, IntegerAttr, FloatAttr, StringLiteralAttr, StringLiteralResourceAttr,
+        VoidAttr
     >;
 
 } // namespace vast::core
@@ -23,3 +23,10 @@ VAST_RELAX_WARNINGS
 namespace vast {
     VAST_REGISTER_ENUM_TYPE(core, GlobalLinkageKind);
 } // namespace vast
+
+namespace vast::core
+{
+    // Registers dedicated bytecode encoding of core attributes and types.
+    void add_bytecode_interface(CoreDialect *dialect);
+
+} // namespace vast::core
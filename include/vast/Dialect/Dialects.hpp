@@ -5,6 +5,8 @@
 #include "vast/Util/Warnings.hpp"
 
 VAST_RELAX_WARNINGS
+#include "mlir/Dialect/DLTI/DLTI.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/IR/Dialect.h"
 VAST_UNRELAX_WARNINGS
 
@@ -36,4 +38,24 @@ namespace vast {
         mctx.appendDialectRegistry(registry);
     }
 
+    // Dialects that make up modules emitted by vast codegen. Any other
+    // upstream dialect is loaded on demand, e.g., as a dependent dialect of a
+    // pass that needs it.
+    inline void registerMinimalDialects(mlir::DialectRegistry &registry) {
+        vast::registerAllDialects(registry);
+        registry.insert< mlir::LLVM::LLVMDialect, mlir::DLTIDialect >();
+    }
+
+    // Loads only the minimal dialects, even if the context has more dialects
+    // registered, e.g., when it is reused across translation units.
+    inline void loadMinimalDialects(mcontext_t &mctx) {
+        mlir::DialectRegistry registry;
+        vast::registerMinimalDialects(registry);
+        mctx.appendDialectRegistry(registry);
+
+        for (auto name : registry.getDialectNames()) {
+            mctx.getOrLoadDialect(name);
+        }
+    }
+
 } // namespace vast
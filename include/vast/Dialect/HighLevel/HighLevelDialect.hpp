@@ -21,4 +21,11 @@ VAST_RELAX_WARNINGS
 // Pull in all enum type definitions and utility function declarations.
 #include "vast/Dialect/HighLevel/HighLevelEnums.h.inc"
 
+namespace vast::hl
+{
+    // Registers dedicated bytecode encoding of high-level types.
+    void add_bytecode_interface(HighLevelDialect *dialect);
+
+} // namespace vast::hl
+
 
@@ -21,6 +21,8 @@ namespace vast::hl
 
     std::unique_ptr< mlir::Pass > createDCEPass();
 
+    std::unique_ptr< mlir::Pass > createPruneUnusedTypesPass();
+
     std::unique_ptr< mlir::Pass > createLowerTypeDefsPass();
 
     std::unique_ptr< mlir::Pass > createSpliceTrailingScopes();
@@ -36,8 +38,9 @@ namespace vast::hl
 
     static inline void build_simplify_hl_pipeline(mlir::PassManager &pm)
     {
-        pm.addPass(createHLLowerTypesPass());
         pm.addPass(createDCEPass());
+        pm.addPass(createPruneUnusedTypesPass());
+        pm.addPass(createHLLowerTypesPass());
         pm.addPass(createLowerTypeDefsPass());
     }
 
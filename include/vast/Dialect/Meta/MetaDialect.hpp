@@ -28,4 +28,7 @@ namespace vast::meta
 
     std::vector< mlir::Operation * > get_with_meta_location(mlir::Operation *scope, identifier_t id);
 
+    // Registers dedicated bytecode encoding of meta attributes.
+    void add_bytecode_interface(MetaDialect *dialect);
+
 } // namespace vast::meta
@@ -35,7 +35,7 @@ namespace vast::cc {
 
     protected:
 
-        vast_action(output_type action, const vast_args &vargs);
+        vast_action(output_type action, const vast_args &vargs, mcontext_t *mctx);
 
         std::unique_ptr< clang::ASTConsumer >
         CreateASTConsumer(compiler_instance &ci, string_ref input) override;
@@ -48,13 +48,17 @@ namespace vast::cc {
         friend struct vast_consumer;
 
         const vast_args &vargs;
+
+        // Context to reuse for the emitted module, if not set the consumer
+        // creates its own.
+        mcontext_t *mctx;
     };
 
     //
     // Emit assembly
     //
     struct emit_assembly_action : vast_action {
-        explicit emit_assembly_action(const vast_args &vargs);
+        explicit emit_assembly_action(const vast_args &vargs, mcontext_t *mctx = nullptr);
     private:
         virtual void anchor();
     };
@@ -63,7 +67,7 @@ namespace vast::cc {
     // Emit LLVM
     //
     struct emit_llvm_action : vast_action {
-        explicit emit_llvm_action(const vast_args &vargs);
+        explicit emit_llvm_action(const vast_args &vargs, mcontext_t *mctx = nullptr);
     private:
         virtual void anchor();
     };
@@ -72,7 +76,16 @@ namespace vast::cc {
     // Emit MLIR
     //
     struct emit_mlir_action : vast_action {
-        explicit emit_mlir_action(const vast_args &vargs);
+        explicit emit_mlir_action(const vast_args &vargs, mcontext_t *mctx = nullptr);
+    private:
+        virtual void anchor();
+    };
+
+    //
+    // Emit several stages at once (-vast-emit), each to its own file
+    //
+    struct emit_stages_action : vast_action {
+        explicit emit_stages_action(const vast_args &vargs, mcontext_t *mctx = nullptr);
     private:
         virtual void anchor();
     };
@@ -81,7 +94,7 @@ namespace vast::cc {
     // Emit obj
     //
     struct emit_obj_action : vast_action {
-        explicit emit_obj_action(const vast_args &vargs);
+        explicit emit_obj_action(const vast_args &vargs, mcontext_t *mctx = nullptr);
     private:
         virtual void anchor();
     };
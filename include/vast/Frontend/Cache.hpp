@@ -0,0 +1,93 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/BLAKE3.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Frontend/CompilerInstance.hpp"
+#include "vast/Frontend/Options.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace vast::cc {
+
+    // Hasher of cache keys. Strings are prefixed by their size to keep
+    // adjacent values apart.
+    struct key_hasher {
+        void add(string_ref str);
+        void add(std::uint64_t value);
+
+        // Hex digest of the values added so far, the hasher can be extended
+        // further.
+        std::string final();
+
+        llvm::BLAKE3 hasher;
+    };
+
+    // Identifies the vast build, as the version alone does not change with
+    // every build.
+    std::string build_identity();
+
+    // Identifies the build together with the options that affect every
+    // declaration of the translation unit (language, target and preprocessor).
+    std::string compilation_identity(compiler_instance &ci);
+
+    // Entries are spread over subdirectories named by the first two
+    // characters of their key.
+    std::string cache_entry_path(string_ref dir, string_ref key, string_ref extension = "");
+
+    // Reads a module entry, a missing or broken entry yields a null module.
+    owning_module_ref read_module_entry(string_ref path, mcontext_t &mctx);
+
+    // Writes a module entry in bytecode. Concurrent writers produce the same
+    // entry, so it is written to a temporary file renamed into place.
+    bool write_module_entry(string_ref path, vast_module mod);
+
+    //
+    // Content-addressed cache of vast-front outputs (-vast-cache-dir).
+    //
+    // An entry is keyed by a hash of the preprocessed translation unit, the
+    // options that affect compilation (target, language, diagnostic and
+    // codegen options), the vast options and the vast build. Only compilations that succeeded
+    // without any diagnostic are stored, so a hit is indistinguishable from a
+    // real compilation.
+    //
+    // Entries are written to a temporary file and renamed into place, so
+    // concurrent writers never expose a partial entry. Hits refresh the entry
+    // modification time, which is used to evict least recently used entries
+    // once the cache exceeds its size limit (-vast-cache-size in MiB). The
+    // size of the cache is tracked in an index file, the cache is scanned
+    // only when a store grows it past the limit.
+    //
+    struct result_cache {
+        // Returns the cache entry of the compilation, or nothing if the
+        // compilation cannot be cached.
+        static std::optional< result_cache > get(compiler_instance &ci, const vast_args &vargs);
+
+        // Writes the cached output if there is one.
+        bool restore() const;
+
+        // Stores the output of a successful compilation.
+        void store(compiler_instance &ci) const;
+
+        static constexpr std::uint64_t default_size = 1024;
+
+        std::string dir;
+        std::string key;
+        std::string output;
+        std::uint64_t max_size;
+
+      private:
+        std::string entry_path() const;
+        std::string size_index_path() const;
+        void evict() const;
+    };
+
+} // namespace vast::cc
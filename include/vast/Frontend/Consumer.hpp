@@ -27,16 +27,38 @@ namespace vast::cc {
 
     using backend = clang::BackendAction;
 
+    struct header_cache;
+    struct function_cache;
+
+    // Stages of the compilation that can be written by a single run, in the
+    // order in which the module is lowered through them.
+    enum class emit_stage { high_level, llvm_dialect, llvm_ir, assembly, object };
+
+    struct emit_request {
+        emit_stage stage;
+        string_ref path;
+    };
+
+    using emit_requests = std::vector< emit_request >;
+
+    // Parses -vast-emit=<stage>:<path>,<stage>:<path>,...
+    [[nodiscard]] emit_requests parse_emit_requests(string_ref from);
+
     struct vast_consumer : clang_ast_consumer
     {
         vast_consumer(
             output_type act, action_options opts,
-            const vast_args &vargs, output_stream_ptr os
+            const vast_args &vargs, output_stream_ptr os,
+            mcontext_t *mctx = nullptr, std::shared_ptr< header_cache > headers = nullptr,
+            std::shared_ptr< function_cache > functions = nullptr
         )
             : action(act)
             , opts(std::move(opts))
             , vargs(vargs)
             , output_stream(std::move(os))
+            , headers(std::move(headers))
+            , functions(std::move(functions))
+            , mctx(mctx)
         {}
 
         void Initialize(acontext_t &ctx) override;
@@ -71,8 +93,18 @@ namespace vast::cc {
             backend backend_action, owning_module_ref mlir_module, mcontext_t *mctx
         );
 
+        void run_backend(backend backend_action, llvm::Module *mod, output_stream_ptr os);
+
+        void emit_stages(const emit_requests &requests, owning_module_ref mod, mcontext_t *mctx);
+
+        output_stream_ptr open_output(string_ref path, bool binary);
+
+        void print_mlir(vast_module mod, llvm::raw_ostream &os);
+
         void emit_mlir_output(target_dialect target, owning_module_ref mod, mcontext_t *mctx);
 
+        void emit_mlir_bytecode(vast_module mod, mcontext_t *mctx);
+
         void compile_via_vast(vast_module mod, mcontext_t *mctx);
 
         virtual void anchor() {}
@@ -87,10 +119,20 @@ namespace vast::cc {
         const vast_args &vargs;
         output_stream_ptr output_stream;
 
+        // Declarations of headers reused across translation units, shared
+        // with the preprocessor callbacks that identify the headers.
+        std::shared_ptr< header_cache > headers;
+
+        // Function bodies reused across compilations.
+        std::shared_ptr< function_cache > functions;
+
         //
         // contexts
         //
-        std::unique_ptr< mcontext_t > mctx = nullptr;
+        // The mlir context is created by the consumer unless the caller
+        // provides one to be reused across translation units.
+        std::unique_ptr< mcontext_t > owned_mctx = nullptr;
+        mcontext_t *mctx = nullptr;
         std::unique_ptr< cg::codegen_context > cgctx = nullptr;
         std::unique_ptr< cg::codegen_driver > codegen = nullptr;
     };
@@ -10,10 +10,15 @@ VAST_RELAX_WARNINGS
 #include <clang/Frontend/CompilerInvocation.h>
 #include <clang/Frontend/TextDiagnosticPrinter.h>
 #include <clang/Driver/Driver.h>
+#include <clang/Driver/DriverDiagnostic.h>
+#include <clang/Driver/InputInfo.h>
+#include <clang/Driver/Options.h>
 #include <llvm/Support/BuryPointer.h>
 #include <llvm/Support/CrashRecoveryContext.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/ThreadPool.h>
 #include <llvm/Support/Timer.h>
 #include <llvm/Support/VirtualFileSystem.h>
 #include <llvm/TargetParser/Host.h>
@@ -97,10 +102,15 @@ namespace vast::cc {
     //
     struct driver {
         using exec_compile_t  = int (*)(argv_storage_base &);
+        using exec_job_t      = int (*)(argv_storage_base &, llvm::raw_ostream &);
         using compilation_ptr = std::unique_ptr< clang_compilation >;
 
-        driver(const std::string &path, argv_storage_base &cmd_args, exec_compile_t cc1, bool canonical_prefixes)
-            : cc1_entry_point(cc1), cmd_args(cmd_args), diag(cmd_args, path)
+        driver(
+            const std::string &path, argv_storage_base &cmd_args, exec_compile_t cc1,
+            bool canonical_prefixes, exec_job_t cc1_job = nullptr
+        )
+            : cc1_entry_point(cc1), cc1_job_entry_point(cc1_job)
+            , cmd_args(cmd_args), diag(cmd_args, path)
             , drv(path, llvm::sys::getDefaultTargetTriple(), diag.engine, "vast compiler")
         {
             drv.ResourceDir = CLANG_RESOURCE_DIR;
@@ -179,7 +189,11 @@ namespace vast::cc {
 
             if (comp && !comp->containsError()) {
                 failing_commands failing;
-                result = drv.ExecuteCompilation(*comp, failing);
+                if (auto jobs = parallel_jobs(*comp)) {
+                    result = execute_parallel(*comp, failing, *jobs);
+                } else {
+                    result = drv.ExecuteCompilation(*comp, failing);
+                }
 
                 for (const auto &[cmd_result, cmd] : failing) {
                     failing_command = cmd;
@@ -251,6 +265,168 @@ namespace vast::cc {
             return result;
         }
 
+        static bool is_cc1_command(const clang_command &cmd) {
+            const auto &args = cmd.getArguments();
+            return !args.empty() && string_ref(args.front()) == "-cc1";
+        }
+
+        // Returns the number of worker threads if the compilation should run
+        // its cc1 jobs concurrently. That is the case if -vast-jobs is given,
+        // cc1 runs in-process and no cc1 job consumes an output of another.
+        std::optional< unsigned > parallel_jobs(const clang_compilation &comp) const {
+            if (!cc1_job_entry_point) {
+                return std::nullopt;
+            }
+
+            auto [vargs, _] = filter_args(cmd_args);
+            auto value = vargs.get_option(opt::jobs);
+            if (!value) {
+                return std::nullopt;
+            }
+
+            unsigned jobs = 0;
+            if (value->getAsInteger(10, jobs)) {
+                VAST_UNREACHABLE("Invalid number of jobs: {0}", *value);
+            }
+
+            namespace options = clang::driver::options;
+            const auto &args = comp.getArgs();
+            if (args.hasArg(options::OPT__HASH_HASH_HASH)) {
+                return std::nullopt;
+            }
+
+            if (!args.hasFlag(options::OPT_fintegrated_cc1, options::OPT_fno_integrated_cc1, true)) {
+                return std::nullopt;
+            }
+
+            std::set< std::string > outputs;
+            std::size_t cc1_count = 0;
+            for (const auto &cmd : comp.getJobs()) {
+                if (!is_cc1_command(cmd)) {
+                    continue;
+                }
+
+                for (const auto &out : cmd.getOutputFilenames()) {
+                    outputs.insert(out);
+                }
+                ++cc1_count;
+            }
+
+            for (const auto &cmd : comp.getJobs()) {
+                if (!is_cc1_command(cmd)) {
+                    continue;
+                }
+
+                for (const auto &in : cmd.getInputInfos()) {
+                    if (in.isFilename() && outputs.contains(in.getFilename())) {
+                        return std::nullopt;
+                    }
+                }
+            }
+
+            if (cc1_count < 2) {
+                return std::nullopt;
+            }
+
+            return jobs;
+        }
+
+        // Counterpart of `ExecuteCompilation` that runs the independent cc1
+        // jobs on a thread pool. Each job is guarded by its own crash recovery
+        // context and buffers its diagnostics, which are printed in the order
+        // of the jobs once all of them finish. The remaining jobs (assembler,
+        // linker) are executed afterwards in order, unless a cc1 job failed.
+        int execute_parallel(clang_compilation &comp, failing_commands &failing, unsigned jobs) {
+            if (drv.getDiags().hasErrorOccurred()) {
+                return 1;
+            }
+
+            struct job_result {
+                const clang_command *cmd;
+                int status = 0;
+                std::string diagnostics;
+            };
+
+            std::vector< job_result > results;
+            for (const auto &cmd : comp.getJobs()) {
+                if (is_cc1_command(cmd)) {
+                    results.push_back({ &cmd });
+                }
+            }
+
+            // Jobs leave the target setup to the process, register all targets
+            // before any of them needs a target machine.
+            llvm::InitializeAllTargets();
+            llvm::InitializeAllTargetMCs();
+            llvm::InitializeAllAsmPrinters();
+            llvm::InitializeAllAsmParsers();
+
+            llvm::ThreadPool pool(llvm::hardware_concurrency(jobs));
+            for (auto &res : results) {
+                pool.async([this, &res] {
+                    argv_storage argv;
+                    argv.push_back(res.cmd->getExecutable());
+                    argv.append(res.cmd->getArguments().begin(), res.cmd->getArguments().end());
+
+                    llvm::raw_string_ostream os(res.diagnostics);
+
+                    llvm::CrashRecoveryContext crc;
+                    crc.DumpStackAndCleanupOnFailure = true;
+                    if (!crc.RunSafely([&] { res.status = cc1_job_entry_point(argv, os); })) {
+                        res.status = crc.RetCode;
+                    }
+                });
+            }
+
+            pool.wait();
+
+            for (const auto &res : results) {
+                llvm::errs() << res.diagnostics;
+                if (res.status != 0) {
+                    failing.emplace_back(res.status, res.cmd);
+                }
+            }
+
+            if (failing.empty()) {
+                for (const auto &cmd : comp.getJobs()) {
+                    if (is_cc1_command(cmd)) {
+                        continue;
+                    }
+
+                    const clang_command *failing_cmd = nullptr;
+                    if (int status = comp.ExecuteCommand(cmd, failing_cmd)) {
+                        failing.emplace_back(status, failing_cmd);
+                        break;
+                    }
+                }
+            }
+
+            int result = 0;
+            for (const auto &[status, cmd] : failing) {
+                if (!drv.isSaveTempsEnabled()) {
+                    const auto *action = llvm::cast< clang::driver::JobAction >(&cmd->getSource());
+                    comp.CleanupFileMap(comp.getResultFiles(), action, true);
+                    if (status < 0) {
+                        comp.CleanupFileMap(comp.getFailureResultFiles(), action, true);
+                    }
+                }
+
+                if (!result) {
+                    result = status;
+                }
+
+                if (status < 0) {
+                    drv.Diag(clang::diag::err_drv_command_signalled)
+                        << cmd->getCreator().getShortName();
+                } else if (status != 1 || !cmd->getCreator().hasGoodDiagnostics()) {
+                    drv.Diag(clang::diag::err_drv_command_failed)
+                        << cmd->getCreator().getShortName() << status;
+                }
+            }
+
+            return result;
+        }
+
         bool set_backdoor_driver_outputs_from_env_vars() {
             drv.CCPrintOptions = check_env_var<bool>(
                 "CC_PRINT_OPTIONS", "CC_PRINT_OPTIONS_FILE", drv.CCPrintOptionsFilename
@@ -342,6 +518,7 @@ namespace vast::cc {
 
 
         exec_compile_t cc1_entry_point;
+        exec_job_t cc1_job_entry_point;
         argv_storage_base &cmd_args;
 
         errs_diagnostics diag;
@@ -31,6 +31,7 @@ namespace vast::cc {
             .target  = ci.getTargetOpts(),
             .lang    = ci.getLangOpts(),
             .front   = ci.getFrontendOpts(),
+            .files   = ci.getFileSystemOpts(),
             .diags   = ci.getDiagnostics(),
             .vfs     = ci.getVirtualFileSystem()
         };
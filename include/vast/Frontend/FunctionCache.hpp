@@ -0,0 +1,75 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseMap.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/CodeGen/CodeGenContext.hpp"
+#include "vast/CodeGen/CodeGenDriver.hpp"
+#include "vast/Frontend/CompilerInstance.hpp"
+#include "vast/Frontend/Options.hpp"
+#include "vast/Util/Common.hpp"
+
+#include <string>
+#include <vector>
+
+namespace vast::cc {
+
+    //
+    // Cache of high-level function bodies (-vast-function-cache). It caches
+    // only the high-level code generation, not lowered code.
+    //
+    // A definition is identified by the ODR hash of its signature and body,
+    // the names and types of the declarations the body refers to and the
+    // types of its expressions. Editing a function changes only its own key,
+    // so a recompilation generates the high-level bodies of the edited
+    // functions and clones the bodies of the others from the cache.
+    //
+    // A cached body is used only if the globals and enumerators it refers to
+    // are already emitted. Functions it calls are declared as if the body was
+    // generated. Location identifiers are stored relative to the body, so a
+    // restored body has the same locations as a generated one.
+    //
+    // Only generation of the high-level body is skipped. Lowering to other
+    // dialects and to LLVM IR still processes the whole module, including the
+    // restored bodies.
+    //
+    struct function_cache final : cg::function_body_cache {
+        function_cache(string_ref dir, std::string seed);
+
+        // Identity of the compilation options that affect generated bodies.
+        static std::string seed(compiler_instance &ci, const vast_args &vargs);
+
+        bool restore(
+            hl::FuncOp fn, const clang::FunctionDecl *decl,
+            cg::codegen_context &cgctx, declare_function declare, reserve_ids reserve
+        ) override;
+
+        void record(
+            hl::FuncOp fn, const clang::FunctionDecl *decl,
+            meta::identifier_t first, meta::identifier_t count
+        ) override;
+
+        // Stores bodies generated for definitions missing in the cache.
+        void store(cg::codegen_context &cgctx);
+
+      private:
+        std::string dir;
+        std::string seed_hash;
+
+        struct generated_body {
+            std::string key;
+            hl::FuncOp fn;
+            meta::identifier_t first;
+            meta::identifier_t count;
+        };
+
+        llvm::DenseMap< const clang::FunctionDecl *, std::string > missing;
+        std::vector< generated_body > generated;
+    };
+
+} // namespace vast::cc
@@ -0,0 +1,91 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <clang/Basic/SourceManager.h>
+#include <clang/Lex/PPCallbacks.h>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/STLFunctionalExtras.h>
+#include <llvm/ADT/StringMap.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/CodeGen/CodeGenContext.hpp"
+#include "vast/Util/Common.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clang {
+    class Preprocessor;
+} // namespace clang
+
+namespace vast::cc {
+
+    //
+    // Cache of high-level declarations emitted for headers (-vast-header-cache).
+    //
+    // A header is identified by its path and content, the compiler options and
+    // the macro definitions preceding its inclusion. Typedefs, tag declarations
+    // and function prototypes emitted for a header are stored in bytecode once
+    // per identity. Later translation units splice the stored operations into
+    // their module instead of generating them and register them in the symbol
+    // tables of the codegen context.
+    //
+    // Declarations that cannot be found in the stored entry are generated as
+    // usual. Headers entered more than once or declaring anonymous tags, whose
+    // names depend on the translation unit, are not stored. Declarations whose
+    // expressions refer to declarations outside of their header, e.g., an
+    // array size given by an enumerator of the main file, are neither stored
+    // nor reused, as the key does not cover the values they resolve to.
+    //
+    struct header_cache {
+        // The seed identifies the compilation shared by all its headers.
+        header_cache(string_ref dir, std::string seed);
+
+        // Tracks header identities while the preprocessor runs.
+        std::unique_ptr< clang::PPCallbacks > make_tracker(clang::Preprocessor &pp);
+
+        // Handles a top-level declaration, either by the cached operations of
+        // its header or by `generate`. Operations generated for headers missing
+        // in the cache are recorded to be stored.
+        void handle(
+            clang::Decl *decl, cg::codegen_context &cgctx, llvm::function_ref< void() > generate
+        );
+
+        // Stores declarations generated for headers missing in the cache.
+        void store(cg::codegen_context &cgctx);
+
+      private:
+        struct header {
+            std::string key;
+            bool cacheable = true;
+            bool looked_up = false;
+            owning_module_ref entry;
+            llvm::StringMap< operation > ops;
+        };
+
+        friend struct header_tracker;
+
+        header *get_header(clang::SourceLocation loc, const clang::SourceManager &sm);
+        void load(header &hdr, mcontext_t &mctx);
+
+        operation clone(operation op, cg::codegen_context &cgctx);
+
+        bool reuse(clang::Decl *decl, header &hdr, cg::codegen_context &cgctx);
+
+        bool reuse_typedef(const clang::TypedefDecl *decl, header &hdr, cg::codegen_context &cgctx);
+        bool reuse_record(const clang::RecordDecl *decl, header &hdr, cg::codegen_context &cgctx);
+        bool reuse_enum(const clang::EnumDecl *decl, header &hdr, cg::codegen_context &cgctx);
+        bool reuse_function(const clang::FunctionDecl *decl, header &hdr, cg::codegen_context &cgctx);
+
+        std::string dir;
+        std::string seed_hash;
+
+        llvm::DenseMap< const clang::FileEntry *, header > headers;
+    };
+
+} // namespace vast::cc
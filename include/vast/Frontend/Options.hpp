@@ -5,6 +5,7 @@
 #include "vast/Util/Warnings.hpp"
 
 VAST_RELAX_WARNINGS
+#include <clang/Basic/FileSystemOptions.h>
 #include <clang/Lex/HeaderSearchOptions.h>
 #include <clang/Basic/CodeGenOptions.h>
 #include <clang/Basic/LangOptions.h>
@@ -27,6 +28,7 @@ namespace vast::cc
     using target_options        = clang::TargetOptions;
     using language_options      = clang::LangOptions;
     using frontend_options      = clang::FrontendOptions;
+    using file_system_options   = clang::FileSystemOptions;
 
     using diagnostics_engine    = clang::DiagnosticsEngine;
 
@@ -38,10 +40,15 @@ namespace vast::cc
         const target_options &target;
         const language_options &lang;
         const frontend_options &front;
+        const file_system_options &files;
         diagnostics_engine &diags;
         virtual_file_system &vfs;
     };
 
+    // Resolves a relative path against -working-directory, so that outputs
+    // do not depend on the working directory of the process.
+    std::string working_path(const file_system_options &files, string_ref path);
+
     constexpr string_ref vast_option_prefix = "-vast-";
 
     struct vast_args
@@ -54,6 +61,8 @@ namespace vast::cc
         // detects the presence of an option in one of formats:
         // (1) -vast-"name"
         // (2) -vast-"name"="value"
+        // the name has to match exactly, i.e., "emit-mlir" does not match
+        // -vast-emit-mlir-bytecode
         bool has_option(string_ref opt) const;
 
         // from option of form -vast-"name"="value" returns the "value"
@@ -73,12 +82,27 @@ namespace vast::cc
         constexpr string_ref emit_asm  = "emit-asm";
 
         constexpr string_ref emit_mlir = "emit-mlir";
+        constexpr string_ref emit_mlir_bytecode = "emit-mlir-bytecode";
 
         constexpr string_ref emit_locs = "emit-locs";
 
+        // -vast-emit=<stage>:<path>,... writes several stages from one run
+        constexpr string_ref emit = "emit";
+
+        constexpr string_ref strlit_resource_threshold = "strlit-resource-threshold";
+
         constexpr string_ref opt_pipeline  = "pipeline";
 
+        constexpr string_ref jobs = "jobs";
+
+        constexpr string_ref cache_dir  = "cache-dir";
+        constexpr string_ref cache_size = "cache-size";
+
+        constexpr string_ref header_cache   = "header-cache";
+        constexpr string_ref function_cache = "function-cache";
+
         constexpr string_ref disable_vast_verifier = "disable-vast-verifier";
+        constexpr string_ref verify_functions = "verify-functions";
         constexpr string_ref vast_verify_diags = "verify-diags";
         constexpr string_ref disable_emit_cxx_default = "disable-emit-cxx-default";
 
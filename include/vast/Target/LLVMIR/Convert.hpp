@@ -55,6 +55,9 @@ namespace vast::target::llvmir
     }
 
     void register_vast_to_llvm_ir(mlir::DialectRegistry &registry);
+
+    // Registers the translations with the context, does nothing if they are
+    // already registered.
     void register_vast_to_llvm_ir(mcontext_t &mctx);
 
 } // namespace vast::target::llvmir
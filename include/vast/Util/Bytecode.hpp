@@ -0,0 +1,58 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Bytecode/BytecodeReader.h>
+#include <mlir/IR/Block.h>
+#include <mlir/Parser/Parser.h>
+
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/SourceMgr.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <memory>
+
+namespace vast::util {
+
+    bool is_bytecode(const llvm::MemoryBuffer &buffer);
+
+    //
+    // Module read from MLIR bytecode, whose function bodies are loaded only
+    // when they are requested. Until then, functions have empty regions.
+    //
+    struct lazy_module {
+        static std::unique_ptr< lazy_module > read(
+            std::unique_ptr< llvm::MemoryBuffer > buffer, mcontext_t *ctx
+        );
+
+        vast_module get();
+
+        // Loads bodies of `root` and of all operations nested in it.
+        logical_result materialize(operation root);
+
+        logical_result materialize_all() { return materialize(get()); }
+
+        // Loads the whole module and detaches it, the lazy module is empty
+        // afterwards.
+        owning_module_ref release();
+
+        // Number of operations whose bodies were not loaded yet.
+        std::int64_t pending() const { return reader->getNumOpsToMaterialize(); }
+
+      private:
+        lazy_module(std::unique_ptr< llvm::MemoryBuffer > buffer, mcontext_t *ctx);
+
+        mlir::ParserConfig config;
+        std::shared_ptr< llvm::SourceMgr > source_mgr;
+        std::unique_ptr< mlir::BytecodeReader > reader;
+
+        // Owns the top-level module.
+        mlir::Block block;
+    };
+
+} // namespace vast::util
@@ -0,0 +1,112 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#pragma once
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/Support/Endian.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+
+//
+// On-disk symbol index of a vast module.
+//
+// The index stores everything needed to answer symbol queries without
+// parsing the module. It consists of a fixed header followed by arrays of
+// fixed-size records and a string table. All integers are little endian, so
+// the index can be used directly from a memory mapped file.
+//
+// Symbols and users are stored in the order in which the module walk visits
+// them. Each record carries its pre-order position in the module (`offset`)
+// and the position of its last nested operation (`end`), which are used to
+// constrain queries to a scope.
+//
+namespace vast::query::index
+{
+    using u32 = llvm::support::ulittle32_t;
+
+    enum symbol_flags : std::uint32_t {
+        none_flag     = 0,
+        function_flag = 1 << 0,
+        type_flag     = 1 << 1,
+        record_flag   = 1 << 2,
+        var_flag      = 1 << 3,
+        global_flag   = 1 << 4,
+        // mlir symbol, its users are resolved in the queried scope
+        mlir_symbol_flag = 1 << 5,
+        // symbol nested directly in a symbol table, usable as a query scope
+        table_symbol_flag = 1 << 6
+    };
+
+    struct string_record {
+        u32 offset;
+        u32 size;
+    };
+
+    struct symbol_record {
+        string_record kind;
+        string_record name;
+        string_record location;
+        u32 offset;
+        u32 end;
+        u32 flags;
+        u32 users_begin;
+        u32 users_count;
+    };
+
+    struct user_record {
+        string_record text;
+        string_record location;
+        u32 offset;
+    };
+
+    struct header {
+        char magic[8];
+        u32 version;
+        u32 symbols_count;
+        u32 users_count;
+        u32 strings_size;
+    };
+
+    static constexpr char magic[8] = { 'V', 'A', 'S', 'T', 'Q', 'I', 'D', 'X' };
+    static constexpr std::uint32_t version = 1;
+
+    // Writes index of `mod` to the `os` stream.
+    void write(vast_module mod, llvm::raw_ostream &os);
+
+    bool is_index(const llvm::MemoryBuffer &buffer);
+
+    // Read-only view of an index, it does not copy the underlying buffer. The
+    // records are validated against the buffer when the view is created.
+    struct view {
+        static std::optional< view > get(std::unique_ptr< llvm::MemoryBuffer > buffer);
+
+        std::span< const symbol_record > symbols() const { return _symbols; }
+
+        std::span< const user_record > users(const symbol_record &symbol) const {
+            return _users.subspan(symbol.users_begin, symbol.users_count);
+        }
+
+        string_ref str(const string_record &rec) const {
+            return _strings.substr(rec.offset, rec.size);
+        }
+
+      private:
+        view() = default;
+
+        std::shared_ptr< llvm::MemoryBuffer > _buffer;
+        std::span< const symbol_record > _symbols;
+        std::span< const user_record > _users;
+        string_ref _strings;
+    };
+
+} // namespace vast::query::index
@@ -25,4 +25,6 @@ namespace vast::repl::codegen {
 
     owning_module_ref emit_module(const std::string &source, mcontext_t *ctx);
 
+    owning_module_ref emit_module(clang::ASTUnit &unit, mcontext_t *ctx);
+
 } // namespace vast::repl::codegen
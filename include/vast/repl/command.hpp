@@ -21,6 +21,7 @@ VAST_UNRELAX_WARNINGS
 #include <filesystem>
 #include <tuple>
 #include <span>
+#include <vector>
 
 namespace vast::repl
 {
@@ -38,7 +39,7 @@ namespace vast::repl
 
         void check_source(const state_t &state);
 
-        const std::string &get_source(const state_t &state);
+        const std::string &get_source(state_t &state);
 
         void check_and_emit_module(state_t &state);
 
@@ -49,6 +50,7 @@ namespace vast::repl
         struct flag_param    { bool set; };
         struct string_param  { std::string value; };
         struct integer_param { std::uint64_t value; };
+        struct list_param    { std::vector< std::string > values; };
 
         enum class show_kind { source, ast, module, symbols };
 
@@ -104,6 +106,15 @@ namespace vast::repl
                 return { .value = from_string< base >(token) };
             }
 
+            // List parameter consumes all remaining tokens.
+            static constexpr bool is_list_param = std::is_same_v< base, list_param >;
+            static named_param parse(std::span< string_ref > tokens) requires(is_list_param) {
+                list_param param;
+                for (auto token : tokens)
+                    param.values.push_back(token.str());
+                return { param };
+            }
+
             base value;
         };
 
@@ -238,7 +249,31 @@ namespace vast::repl
             params_storage params;
         };
 
-        using command_list = util::type_list< exit, help, load, show, meta, raise >;
+        //
+        // run command
+        //
+        struct run_function : base {
+            static constexpr string_ref name() { return "run"; }
+
+            static constexpr inline char function_param[]  = "function";
+            static constexpr inline char arguments_param[] = "arguments";
+
+            using command_params = util::type_list<
+                named_param< function_param, string_param >,
+                named_param< arguments_param, list_param >
+            >;
+
+            using params_storage = command_params::as_tuple;
+
+            run_function(const params_storage &params) : params(params) {}
+            run_function(params_storage &&params) : params(std::move(params)) {}
+
+            void run(state_t &state) const override;
+
+            params_storage params;
+        };
+
+        using command_list = util::type_list< exit, help, load, show, meta, raise, run_function >;
 
     } // namespace command
 
@@ -270,8 +305,13 @@ namespace vast::repl
             using current_param = typename params_list::head;
             using rest          = typename params_list::tail;
 
-            auto param = std::make_tuple(current_param::parse(tokens.front()));
-            return std::tuple_cat(param, parse_params< rest >(tail(tokens)));
+            if constexpr (current_param::is_list_param) {
+                static_assert(rest::empty, "list parameter has to be the last one");
+                return std::make_tuple(current_param::parse(tokens));
+            } else {
+                auto param = std::make_tuple(current_param::parse(tokens.front()));
+                return std::tuple_cat(param, parse_params< rest >(tail(tokens)));
+            }
         }
     }
 
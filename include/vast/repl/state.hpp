@@ -2,9 +2,24 @@
 
 #pragma once
 
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/ExecutionEngine/ExecutionEngine.h>
+
+#include <clang/Frontend/ASTUnit.h>
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/Hashing.h>
+#include <llvm/Support/Chrono.h>
+VAST_UNRELAX_WARNINGS
+
 #include "vast/Tower/Tower.hpp"
+#include "vast/Util/Bytecode.hpp"
 #include "vast/repl/common.hpp"
 
+#include <filesystem>
+
 namespace vast::repl {
 
     struct state_t {
@@ -14,8 +29,36 @@ namespace vast::repl {
 
         std::optional< std::string > source;
 
+        // File the source was loaded from together with its stamp at the time
+        // of loading, used to detect changes made outside of the repl.
+        struct source_stamp {
+            std::filesystem::path path;
+            llvm::sys::TimePoint<> mtime;
+            llvm::hash_code hash;
+        };
+
+        std::optional< source_stamp > stamp;
+
+        // Clang AST of the loaded source, parsed on first use and shared by
+        // all commands until the source changes.
+        std::unique_ptr< clang::ASTUnit > unit;
+
+        // Module loaded from MLIR bytecode instead of a source, function
+        // bodies are read once a command needs the module.
+        std::unique_ptr< util::lazy_module > bytecode;
+
         mcontext_t &ctx;
         std::optional< tw::default_tower > tower;
+
+        // Tower layer lowered to the LLVM dialect together with its JIT
+        // compiled code.
+        struct jit_layer {
+            owning_module_ref mod;
+            std::unique_ptr< mlir::ExecutionEngine > engine;
+        };
+
+        // Compiled layers indexed by the tower layer id.
+        llvm::DenseMap< std::size_t, jit_layer > jit_cache;
     };
 
 } // namespace vast::repl
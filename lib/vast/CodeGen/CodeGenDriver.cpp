@@ -3,8 +3,10 @@
 #include "vast/CodeGen/CodeGenDriver.hpp"
 
 VAST_RELAX_WARNINGS
+#include <clang/AST/Attr.h>
 #include <clang/AST/GlobalDecl.h>
 #include <clang/Basic/TargetInfo.h>
+#include <mlir/IR/Verifier.h>
 VAST_UNRELAX_WARNINGS
 
 // FIXME: get rid of dependency from upper layer
@@ -79,6 +81,10 @@ namespace vast::cg
     void codegen_driver::finalize() {
         codegen.emit_data_layout();
         build_deferred();
+        // The rest of finalization may modify functions under verification.
+        if (verifier) {
+            verifier->wait();
+        }
         // TODO: buildVTablesOpportunistically();
         // TODO: applyGlobalValReplacements();
         apply_replacements();
@@ -123,7 +129,32 @@ namespace vast::cg
     }
 
     bool codegen_driver::verify_module() const {
-        return codegen.verify_module();
+        if (!verifier) {
+            return codegen.verify_module();
+        }
+
+        if (!verifier->wait()) {
+            return false;
+        }
+
+        // Functions generated by the driver are verified already, what is
+        // left are the module-level invariants and the other operations.
+        auto mod = cgctx.mod.get();
+        if (mlir::failed(mlir::verify(mod, /* verifyRecursively */ false))) {
+            return false;
+        }
+
+        for (auto &op : mod.getBody()->getOperations()) {
+            if (!verifier->covers(&op) && mlir::failed(mlir::verify(&op))) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void codegen_driver::enable_function_verifier() {
+        verifier = std::make_unique< function_verifier >(mctx);
     }
 
     void codegen_driver::build_deferred_decls() {
@@ -146,6 +177,7 @@ namespace vast::cg
     }
 
     void codegen_driver::handle_translation_unit(acontext_t &/* acontext */) {
+        handle_external_decls();
         finalize();
     }
 
@@ -187,11 +219,78 @@ namespace vast::cg
                 }
                 break;
             }
+            case clang::Decl::Import: {
+                // The imported module may bring declarations that were not
+                // emitted yet.
+                build_external_decls();
+                break;
+            }
             default:
                 return codegen.append_to_module(decl);
         }
     }
 
+    void codegen_driver::handle_inline_function_definition(clang::FunctionDecl *decl) {
+        VAST_ASSERT(decl->doesThisDeclarationHaveABody());
+
+        // We may want to emit this definition. However, that decision might be
+        // based on computing the linkage, and we have to defer that in case we
+        // are inside of something that will change the method's final linkage,
+        // e.g.
+        //   typedef struct { void bar(); void foo() { bar(); } } A;
+        defer_handle_of_top_level_decl defer(*this);
+        deferred_inline_member_func_defs.push_back(decl);
+    }
+
+    void codegen_driver::handle_cxx_static_member_var_instantiation(clang::VarDecl *decl) {
+        auto kind = decl->isThisDeclarationADefinition();
+        if (kind == clang::VarDecl::Definition && decl->hasAttr< clang::DLLImportAttr >()) {
+            return;
+        }
+
+        // If we have a definition, this might be a deferred decl. If the
+        // instantiation is explicit, make sure we emit it at the end.
+        auto tsk = decl->getTemplateSpecializationKind();
+        if (decl->getDefinition() && tsk == clang::TSK_ExplicitInstantiationDefinition) {
+            VAST_UNIMPLEMENTED_MSG("explicit instantiation of static data member");
+        }
+
+        handle_top_level_decl(decl);
+    }
+
+    void codegen_driver::handle_external_decls() {
+        if (!actx.getExternalSource()) {
+            return;
+        }
+
+        // The reader marks the translation unit whenever a newly loaded file
+        // brings top-level declarations.
+        auto tu = actx.getTranslationUnitDecl();
+        if (external_decls_visited && !tu->hasExternalLexicalStorage()) {
+            return;
+        }
+
+        build_external_decls();
+    }
+
+    void codegen_driver::build_external_decls() {
+        external_decls_visited = true;
+
+        // Collect the declarations first, as generating code may deserialize
+        // more of them into the translation unit.
+        llvm::SmallVector< clang::Decl *, 64 > decls;
+        for (auto decl : actx.getTranslationUnitDecl()->decls()) {
+            if (decl->isFromASTFile() && external_decls.insert(decl).second) {
+                decls.push_back(decl);
+            }
+        }
+
+        defer_handle_of_top_level_decl defer(*this);
+        for (auto decl : decls) {
+            handle_top_level_decl(decl);
+        }
+    }
+
     function_processing_lock codegen_driver::make_lock(const function_info_t *fninfo) {
         return function_processing_lock(type_conv, fninfo);
     }
@@ -226,6 +325,22 @@ namespace vast::cg
 
     }
 
+    bool codegen_driver::restore_function_body(hl::FuncOp fn, const clang::FunctionDecl *decl) {
+        if (!functions) {
+            return false;
+        }
+
+        auto declare = [&] (const clang::FunctionDecl *callee) {
+            return mlir::cast< hl::FuncOp >(build_global_function_declaration(callee));
+        };
+
+        auto reserve = [&] (meta::identifier_t count) {
+            return codegen.meta.reserve(count);
+        };
+
+        return functions->restore(fn, decl, cgctx, declare, reserve);
+    }
+
     operation codegen_driver::build_global_function_declaration(clang::GlobalDecl decl) {
         const auto &fty_info = type_info->arrange_global_decl(decl, get_target_info());
         auto ty = type_conv.get_function_type(fty_info);
@@ -250,7 +365,17 @@ namespace vast::cg
         // TODO maybeSetTrivialComdat
         // TODO setLLVMFunctionFEnvAttributes
 
-        fn = build_function_body(fn, decl, fty_info);
+        if (!restore_function_body(fn, function_decl)) {
+            auto first = codegen.meta.next_id();
+            fn = build_function_body(fn, decl, fty_info);
+            if (functions && fn) {
+                functions->record(fn, function_decl, first, codegen.meta.next_id() - first);
+            }
+        }
+
+        if (verifier && fn) {
+            verifier->verify(fn);
+        }
 
         // TODO: setNonAliasAttributes
         // TODO: SetLLVMFunctionAttributesForDeclaration
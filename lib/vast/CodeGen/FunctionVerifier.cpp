@@ -0,0 +1,54 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/CodeGen/FunctionVerifier.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Verifier.h>
+VAST_UNRELAX_WARNINGS
+
+namespace vast::cg {
+
+    function_verifier::function_verifier(mcontext_t &mctx) : mctx(mctx) {}
+
+    function_verifier::~function_verifier() { wait(); }
+
+    void function_verifier::verify(hl::FuncOp fn) {
+        functions.insert(fn.getOperation());
+
+        auto check = [this, fn] () mutable {
+            if (mlir::failed(mlir::verify(fn))) {
+                mlir::emitError(fn.getLoc())
+                    << "verification of function '" << fn.getSymName() << "' failed";
+                failed = true;
+            }
+        };
+
+        if (!mctx.isMultithreadingEnabled()) {
+            return check();
+        }
+
+        if (!tasks) {
+            diagnostics.emplace(&mctx);
+            tasks = std::make_unique< llvm::ThreadPoolTaskGroup >(mctx.getThreadPool());
+        }
+
+        tasks->async([this, check, id = order++] () mutable {
+            diagnostics->setOrderIDForThread(id);
+            check();
+            diagnostics->eraseOrderIDForThread();
+        });
+    }
+
+    bool function_verifier::wait() {
+        if (tasks) {
+            tasks->wait();
+            tasks.reset();
+            // Emits the held back diagnostics.
+            diagnostics.reset();
+            order = 0;
+        }
+
+        return !failed;
+    }
+
+} // namespace vast::cg
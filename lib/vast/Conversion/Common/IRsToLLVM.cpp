@@ -418,12 +418,49 @@ namespace vast::conv::irstollvm
         }
     };
 
+    struct dense_init_list_expr : base_pattern< hl::DenseInitListExpr >
+    {
+        using op_t = hl::DenseInitListExpr;
+        using base = base_pattern< op_t >;
+        using base::base;
+
+        logical_result matchAndRewrite(
+                op_t op, typename op_t::Adaptor ops,
+                conversion_rewriter &rewriter) const override
+        {
+            auto trg_type = tc.convert_type_to_type(op.getType());
+            VAST_PATTERN_CHECK(trg_type, "Failed conversion of DenseInitListExpr res type");
+            rewriter.replaceOpWithNewOp< LLVM::ConstantOp >(op, *trg_type, op.getValue());
+            return logical_result::success();
+        }
+    };
+
     struct vardecl : base_pattern< hl::VarDeclOp >
     {
         using op_t = hl::VarDeclOp;
         using base = base_pattern< op_t >;
         using base::base;
 
+        // Returns elements of a dense initializer list if it is the whole
+        // initializer of the global, so it can be used as its value directly.
+        static mlir::Attribute dense_initializer(op_t op) {
+            auto &init = op.getInitializer();
+            if (!init.hasOneBlock() || init.front().empty()) {
+                return {};
+            }
+
+            auto yield = mlir::dyn_cast< hl::ValueYieldOp >(init.front().back());
+            if (!yield) {
+                return {};
+            }
+
+            if (auto dense = yield.getResult().getDefiningOp< hl::DenseInitListExpr >()) {
+                return dense.getValue();
+            }
+
+            return {};
+        }
+
         logical_result matchAndRewrite(
                 op_t op, typename op_t::Adaptor ops,
                 conversion_rewriter &rewriter) const override
@@ -431,6 +468,16 @@ namespace vast::conv::irstollvm
             auto t = mlir::dyn_cast< hl::LValueType >(op.getType());
             auto target_type = this->convert(t.getElementType());
 
+            if (auto dense = dense_initializer(op)) {
+                rewriter.replaceOpWithNewOp< mlir::LLVM::GlobalOp >(
+                        op, target_type,
+                        // TODO(conv:irstollvm): Constant.
+                        true,
+                        LLVM::Linkage::Internal,
+                        op.getName(), dense);
+                return logical_result::success();
+            }
+
             // Sadly, we cannot build `mlir::LLVM::GlobalOp` without
             // providing a value attribute.
             auto dummy_value = rewriter.getIntegerAttr(target_type, 0);
@@ -485,6 +532,7 @@ namespace vast::conv::irstollvm
         uninit_var,
         initialize_var,
         init_list_expr,
+        dense_init_list_expr,
         vardecl,
         global_ref
     >;
@@ -642,7 +690,12 @@ namespace vast::conv::irstollvm
             if (mlir::isa< mlir::NoneType >(op.getResult().getType())) {
                 return handle_void_const(op, rewriter);
             }
-            rewriter.replaceOp(op, make_from(op, rewriter, this->type_converter()));
+            auto value = make_from(op, rewriter, this->type_converter());
+            if (!value) {
+                return logical_result::failure();
+            }
+
+            rewriter.replaceOp(op, value);
             return logical_result::success();
         }
 
@@ -682,8 +735,31 @@ namespace vast::conv::irstollvm
             // if we "just" pass the value in.
             auto twine = llvm::Twine(std::string_view(str_lit.getValue().data(),
                                                       str_lit.getValue().size() + 1));
-            auto converted_attr = mlir::StringAttr::get(op->getContext(), twine);
+            return make_strlit_global(op, rewriter, target_type,
+                                      mlir::StringAttr::get(op->getContext(), twine));
+        }
 
+        mlir::Value convert_strlit(hl::ConstantOp op, auto rewriter, auto &tc,
+                                   mlir_type target_type,
+                                   core::StringLiteralResourceAttr str_lit) const
+        {
+            auto data = str_lit.getRawData();
+            if (!data) {
+                op.emitError("string literal resource has no data");
+                return {};
+            }
+
+            // The blob does not contain the terminating `0`.
+            std::string value(data->data(), data->size());
+            value.push_back('\0');
+            return make_strlit_global(op, rewriter, target_type,
+                                      mlir::StringAttr::get(op->getContext(), value));
+        }
+
+        mlir::Value make_strlit_global(hl::ConstantOp op, auto rewriter,
+                                       mlir_type target_type,
+                                       mlir::StringAttr converted_attr) const
+        {
             auto ptr_type = mlir::dyn_cast< mlir::LLVM::LLVMPointerType >(target_type);
 
             auto mod = op->getParentOfType< mlir::ModuleOp >();
@@ -718,6 +794,10 @@ namespace vast::conv::irstollvm
                 return convert_strlit(op, rewriter_wrapper_t(rewriter), tc,
                                       target_type, str_lit);
 
+            if (auto str_lit = mlir::dyn_cast< core::StringLiteralResourceAttr >(op.getValue()))
+                return convert_strlit(op, rewriter_wrapper_t(rewriter), tc,
+                                      target_type, str_lit);
+
             auto attr = convert_attr(op.getValue(), op, rewriter);
             return rewriter.create< LLVM::ConstantOp >(op.getLoc(), target_type, attr);
         }
@@ -1038,6 +1118,7 @@ namespace vast::conv::irstollvm
     >;
 
 
+
     template< typename Src, typename Trg >
     struct assign_pattern : base_pattern< Src >
     {
@@ -67,6 +67,32 @@ namespace vast::conv::irstollvm::ll_cf
 
     };
 
+    struct switch_op : base_pattern< ll::Switch >
+    {
+        using base = base_pattern< ll::Switch >;
+        using base::base;
+
+        using op_t = ll::Switch;
+        using adaptor_t = typename op_t::Adaptor;
+
+        logical_result matchAndRewrite(
+            op_t op, adaptor_t ops,
+            conversion_rewriter &rewriter) const override
+        {
+            auto case_values = llvm::to_vector(op.getCaseValues().getValues< llvm::APInt >());
+            rewriter.create< LLVM::SwitchOp >(
+                op.getLoc(),
+                ops.getValue(),
+                op.getDefaultDest(), mlir::ValueRange(),
+                case_values, op.getCaseDests()
+            );
+            rewriter.eraseOp( op );
+
+            return mlir::success();
+        }
+
+    };
+
     template< typename Op >
     struct scope_like : base_pattern< Op >
     {
@@ -173,6 +199,7 @@ namespace vast::conv::irstollvm::ll_cf
     using conversions = util::type_list<
           cond_br
         , br
+        , switch_op
         , scope
     >;
 
@@ -24,8 +24,10 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Conversion/Common/Rewriter.hpp"
 
 
+#include "vast/Dialect/Core/CoreAttributes.hpp"
 #include "vast/Dialect/Core/CoreTraits.hpp"
 #include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 #include "vast/Dialect/LowLevel/LowLevelOps.hpp"
 
 #include "../PassesDetails.hpp"
@@ -97,6 +99,69 @@ namespace vast::conv
             return apply< Fn, Args ... >( std::forward< Fn >( fn ), op );
         }
 
+        // Evaluates the constant integer yielded by a value region.
+        std::optional< llvm::APInt > yielded_constant( mlir::Region &region, unsigned bits )
+        {
+            if ( !region.hasOneBlock() )
+                return std::nullopt;
+
+            llvm::DenseMap< mlir::Value, mlir::Attribute > constants;
+            for ( auto &op : region.front() )
+            {
+                if ( auto yield = mlir::dyn_cast< hl::ValueYieldOp >( op ) )
+                {
+                    auto attr = constants.lookup( yield.getResult() );
+                    if ( auto integer = mlir::dyn_cast_or_null< core::IntegerAttr >( attr ) )
+                        return integer.getValue().sextOrTrunc( bits );
+                    if ( auto integer = mlir::dyn_cast_or_null< mlir::IntegerAttr >( attr ) )
+                        return integer.getValue().sextOrTrunc( bits );
+                    return std::nullopt;
+                }
+
+                llvm::SmallVector< mlir::Attribute > operands;
+                for ( auto operand : op.getOperands() )
+                    operands.push_back( constants.lookup( operand ) );
+
+                llvm::SmallVector< mlir::OpFoldResult > results;
+                if ( mlir::failed( op.fold( operands, results ) ) )
+                    return std::nullopt;
+                if ( results.size() != op.getNumResults() )
+                    return std::nullopt;
+
+                for ( auto [ result, folded ] : llvm::zip( op.getResults(), results ) )
+                {
+                    auto attr = folded.dyn_cast< mlir::Attribute >();
+                    if ( !attr )
+                        attr = constants.lookup( folded.get< mlir::Value >() );
+                    if ( !attr )
+                        return std::nullopt;
+                    constants[ result ] = attr;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        // Replaces `break`s that leave the switch by branches to `exit`.
+        void replace_switch_breaks( mlir::Region &region, mlir::Block *exit,
+                                    conversion_rewriter &rewriter )
+        {
+            region.walk< mlir::WalkOrder::PreOrder >( [ & ]( mlir::Operation *op ) {
+                if ( mlir::isa< hl::ForOp, hl::WhileOp, hl::DoOp, hl::SwitchOp >( op ) )
+                    return mlir::WalkResult::skip();
+
+                if ( mlir::isa< hl::BreakOp >( op ) )
+                {
+                    auto g = mlir::OpBuilder::InsertionGuard( rewriter );
+                    rewriter.setInsertionPointAfter( op );
+                    rewriter.create< ll::Br >( op->getLoc(), exit );
+                    rewriter.eraseOp( op );
+                }
+
+                return mlir::WalkResult::advance();
+            });
+        }
+
     } // namespace
 
     namespace pattern
@@ -124,6 +189,8 @@ namespace vast::conv
             //        - `nullptr` means the next block after scope is used.
             mlir::Block *entry;
             mlir::Block *exit;
+            // `break` inside of a switch leaves the switch, not the loop.
+            bool in_switch = false;
 
             handle_terminators( bld_t &bld, mlir::Block *entry, mlir::Block *exit )
                 : bld( bld ), entry( entry ), exit( exit )
@@ -154,6 +221,18 @@ namespace vast::conv
                 if ( starts_cf_scope( op ) )
                     return mlir::success();
 
+                if ( mlir::isa< hl::SwitchOp >( op ) && !in_switch )
+                {
+                    auto nested = *this;
+                    nested.in_switch = true;
+                    return nested.run_regions( op );
+                }
+
+                return run_regions( op );
+            }
+
+            result_t run_regions( mlir::Operation *op )
+            {
                 for ( auto &region : op->getRegions() )
                     if ( mlir::failed( run( region ) ) )
                         return mlir::failure();
@@ -201,6 +280,9 @@ namespace vast::conv
 
             result_t replace( mlir::Operation *op )
             {
+                if ( in_switch && mlir::isa< hl::BreakOp >( op ) )
+                    return mlir::success();
+
                 auto dispatch = [this]( auto op )
                 {
                     if ( auto replaced = do_replace( op ) )
@@ -428,6 +510,174 @@ namespace vast::conv
             }
         };
 
+        struct switch_op : base_pattern< hl::SwitchOp >
+        {
+            using op_t = hl::SwitchOp;
+            using parent_t = base_pattern< op_t >;
+            using parent_t::parent_t;
+
+            static bool is_case( mlir::Operation *op )
+            {
+                return mlir::isa< hl::CaseOp, hl::DefaultOp >( op );
+            }
+
+            static mlir::Block &case_body( mlir::Operation *op )
+            {
+                if ( auto case_op = mlir::dyn_cast< hl::CaseOp >( op ) )
+                    return case_op.getBody().front();
+                return mlir::cast< hl::DefaultOp >( op ).getBody().front();
+            }
+
+            static mlir::Block *cases_block( op_t op )
+            {
+                auto cases = op.getCases();
+                if ( cases.size() != 1 || !cases.front().hasOneBlock() )
+                    return nullptr;
+                return &cases.front().front();
+            }
+
+            static mlir::IntegerType condition_type( op_t op )
+            {
+                auto &cond = op.getCondRegion();
+                if ( !cond.hasOneBlock() || empty( cond.front() ) )
+                    return {};
+                auto yield = mlir::dyn_cast< hl::ValueYieldOp >( cond.front().back() );
+                if ( !yield )
+                    return {};
+                return mlir::dyn_cast< mlir::IntegerType >( yield.getResult().getType() );
+            }
+
+            // The switch is lowered to a single multi-way branch if each of its
+            // cases is constant and directly in the switch body or directly
+            // in a body of another case (e.g., not in a loop as in Duff's device).
+            // Then every case starts a new block and a fallthrough is a branch
+            // to the following block.
+            static bool is_lowerable( op_t op )
+            {
+                auto type  = condition_type( op );
+                auto block = cases_block( op );
+                if ( !type || !block )
+                    return false;
+
+                // Statements before the first case are unreachable.
+                if ( !empty( *block ) && !is_case( &block->front() ) )
+                    return false;
+
+                auto on_case_level = [ & ]( mlir::Operation *child ) {
+                    auto parent = child->getParentOp();
+                    return parent == op || is_case( parent );
+                };
+
+                auto result = block->walk< mlir::WalkOrder::PreOrder >( [ & ]( mlir::Operation *child ) {
+                    // Cases of nested switch are handled by its own lowering.
+                    if ( mlir::isa< hl::SwitchOp >( child ) )
+                        return mlir::WalkResult::skip();
+
+                    if ( is_case( child ) && !on_case_level( child ) )
+                        return mlir::WalkResult::interrupt();
+
+                    if ( auto case_op = mlir::dyn_cast< hl::CaseOp >( child ) )
+                        if ( !yielded_constant( case_op.getLhs(), type.getWidth() ) )
+                            return mlir::WalkResult::interrupt();
+
+                    // Variables would not dominate uses in the following cases.
+                    if ( mlir::isa< hl::VarDeclOp >( child ) && on_case_level( child ) )
+                        return mlir::WalkResult::interrupt();
+
+                    return mlir::WalkResult::advance();
+                });
+
+                return !result.wasInterrupted();
+            }
+
+            mlir::LogicalResult matchAndRewrite(
+                op_t op,
+                typename op_t::Adaptor ops,
+                conversion_rewriter &rewriter) const override
+            {
+                auto bld = rewriter_wrapper_t( rewriter );
+                auto type = condition_type( op );
+
+                auto [ original_block, tail_block ] = split_at_op( op, rewriter );
+                VAST_CHECK( original_block && tail_block,
+                            "Failed extraction of switch into block." );
+
+                auto &cases_region = op.getCases().front();
+                replace_switch_breaks( cases_region, tail_block, rewriter );
+
+                auto cond_block = inline_region_before( rewriter,
+                                                        op.getCondRegion(), tail_block );
+                auto cond_yield = terminator_t< hl::ValueYieldOp >::get( *cond_block ).op();
+
+                auto body_block = inline_region_before( rewriter, cases_region, tail_block );
+
+                llvm::SmallVector< llvm::APInt > case_values;
+                llvm::SmallVector< mlir::Block * > case_dests;
+                mlir::Block *default_dest = tail_block;
+
+                // Splice body of each case in place of the case, so that nested
+                // cases (e.g., `case 1: case 2:`) get flattened as well.
+                auto current = body_block;
+                for ( auto it = current->begin(); it != current->end(); )
+                {
+                    auto child = &*it;
+                    if ( !is_case( child ) )
+                    {
+                        ++it;
+                        continue;
+                    }
+
+                    auto [ head, case_block, rest ] = extract_as_block( child, rewriter );
+                    rewriter.mergeBlocks( &case_body( child ), case_block, std::nullopt );
+                    rewriter.mergeBlocks( rest, case_block, std::nullopt );
+
+                    VAST_PATTERN_CHECK( parent_t::tie( bld, op.getLoc(), *head, *case_block ),
+                                        tie_fail );
+
+                    if ( auto case_op = mlir::dyn_cast< hl::CaseOp >( child ) )
+                    {
+                        auto value = yielded_constant( case_op.getLhs(), type.getWidth() );
+                        VAST_PATTERN_CHECK( value, "Non-constant case value." );
+                        case_values.push_back( *value );
+                        case_dests.push_back( case_block );
+                    }
+                    else
+                    {
+                        default_dest = case_block;
+                    }
+
+                    rewriter.eraseOp( child );
+                    current = case_block;
+                    it = std::next( mlir::Block::iterator( child ) );
+                }
+
+                VAST_PATTERN_CHECK( parent_t::tie( bld, op.getLoc(), *current, *tail_block ),
+                                    tie_fail );
+
+                bld.make_at_end< ll::Switch >( cond_block, op.getLoc(), cond_yield.getResult(),
+                                               default_dest, case_values, case_dests );
+                rewriter.eraseOp( cond_yield );
+                rewriter.mergeBlocks( cond_block, original_block, std::nullopt );
+
+                if ( !any_terminator_t::has( *tail_block ) )
+                {
+                    bld.guarded_at_end( tail_block, [&](){
+                        bld->template create< ll::ScopeRet >( op.getLoc() );
+                    });
+                }
+                rewriter.eraseOp( op );
+
+                return mlir::success();
+            }
+
+            static void legalize( conversion_target &trg )
+            {
+                trg.addDynamicallyLegalOp< hl::SwitchOp >( [] ( hl::SwitchOp op ) {
+                    return !is_lowerable( op );
+                });
+            }
+        };
+
         template< typename op_t, typename trg_t >
         struct replace : base_pattern< op_t >
         {
@@ -456,6 +706,7 @@ namespace vast::conv
               if_op
             , while_op
             , for_op
+            , switch_op
             , replace< hl::ReturnOp, ll::ReturnOp >
         >;
 
@@ -8,6 +8,7 @@
 VAST_RELAX_WARNINGS
 #include <llvm/ADT/TypeSwitch.h>
 #include <mlir/IR/Builders.h>
+#include <mlir/IR/BuiltinDialect.h>
 #include <mlir/IR/OpImplementation.h>
 #include <mlir/IR/DialectImplementation.h>
 VAST_RELAX_WARNINGS
@@ -106,6 +107,29 @@ namespace vast::core
         printer << ">";
     }
 
+    StringLiteralResourceAttr StringLiteralResourceAttr::get(
+        mlir::Type type, llvm::StringRef name, llvm::StringRef data
+    ) {
+        auto &manager = mlir::DenseResourceElementsHandle::getManagerInterface(
+            type.getContext()
+        );
+
+        auto blob = mlir::HeapAsmResourceBlob::allocateAndCopyInferAlign(
+            llvm::ArrayRef< char >(data.data(), data.size())
+        );
+
+        return get(type, manager.insert(name, std::move(blob)));
+    }
+
+    std::optional< llvm::StringRef > StringLiteralResourceAttr::getRawData() const {
+        if (auto blob = getHandle().getBlob()) {
+            auto data = blob->getData();
+            return llvm::StringRef(data.data(), data.size());
+        }
+
+        return std::nullopt;
+    }
+
     void CoreDialect::registerAttributes()
     {
         addAttributes<
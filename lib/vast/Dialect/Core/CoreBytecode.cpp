@@ -0,0 +1,264 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Bytecode/BytecodeImplementation.h>
+#include <mlir/IR/BuiltinDialect.h>
+
+#include <llvm/ADT/APFloat.h>
+#include <llvm/ADT/APSInt.h>
+#include <llvm/ADT/TypeSwitch.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/Core/CoreAttributes.hpp"
+#include "vast/Dialect/Core/CoreDialect.hpp"
+#include "vast/Dialect/Core/CoreTypes.hpp"
+
+#include "vast/Util/Common.hpp"
+
+namespace vast::core
+{
+    namespace
+    {
+        using reader_t = mlir::DialectBytecodeReader;
+        using writer_t = mlir::DialectBytecodeWriter;
+
+        // Codes of attributes and types in bytecode, new codes have to be
+        // appended to keep the existing bytecode readable.
+        enum class attr_code : std::uint64_t {
+            boolean = 0, integer, floating, strlit, strlit_resource, void_value, source_language
+        };
+
+        enum class type_code : std::uint64_t { function = 0 };
+
+        void write_code(auto code, writer_t &writer) {
+            writer.writeVarInt(static_cast< std::uint64_t >(code));
+        }
+
+        //
+        // Integers are stored with their width and signedness, floats with
+        // their semantics, followed by their bits.
+        //
+        void write_apsint(const llvm::APSInt &value, writer_t &writer) {
+            writer.writeVarInt(value.getBitWidth());
+            writer.writeVarInt(value.isUnsigned());
+            writer.writeAPIntWithKnownWidth(value);
+        }
+
+        mlir::FailureOr< llvm::APSInt > read_apsint(reader_t &reader) {
+            std::uint64_t width, is_unsigned;
+            if (mlir::failed(reader.readVarInt(width)) || mlir::failed(reader.readVarInt(is_unsigned))) {
+                return mlir::failure();
+            }
+
+            auto value = reader.readAPIntWithKnownWidth(static_cast< unsigned >(width));
+            if (mlir::failed(value)) {
+                return mlir::failure();
+            }
+
+            return llvm::APSInt(*value, is_unsigned);
+        }
+
+        void write_apfloat(const llvm::APFloat &value, writer_t &writer) {
+            writer.writeVarInt(llvm::APFloatBase::SemanticsToEnum(value.getSemantics()));
+            writer.writeAPIntWithKnownWidth(value.bitcastToAPInt());
+        }
+
+        mlir::FailureOr< llvm::APFloat > read_apfloat(reader_t &reader) {
+            std::uint64_t kind;
+            if (mlir::failed(reader.readVarInt(kind))) {
+                return mlir::failure();
+            }
+
+            if (kind > llvm::APFloatBase::S_MaxSemantics) {
+                reader.emitError() << "invalid float semantics: " << kind;
+                return mlir::failure();
+            }
+
+            const auto &semantics = llvm::APFloatBase::EnumToSemantics(
+                static_cast< llvm::APFloatBase::Semantics >(kind)
+            );
+
+            auto bits = reader.readAPIntWithKnownWidth(llvm::APFloat::getSizeInBits(semantics));
+            if (mlir::failed(bits)) {
+                return mlir::failure();
+            }
+
+            return llvm::APFloat(semantics, *bits);
+        }
+
+        mlir_attr read_attr(attr_code code, mcontext_t *ctx, reader_t &reader) {
+            mlir_type type;
+            if (code != attr_code::source_language && mlir::failed(reader.readType(type))) {
+                return {};
+            }
+
+            switch (code) {
+                case attr_code::boolean: {
+                    std::uint64_t value;
+                    if (mlir::failed(reader.readVarInt(value))) {
+                        return {};
+                    }
+
+                    return BooleanAttr::get(type, value != 0);
+                }
+                case attr_code::integer: {
+                    auto value = read_apsint(reader);
+                    if (mlir::failed(value)) {
+                        return {};
+                    }
+
+                    return core::IntegerAttr::get(type, *value);
+                }
+                case attr_code::floating: {
+                    auto value = read_apfloat(reader);
+                    if (mlir::failed(value)) {
+                        return {};
+                    }
+
+                    return core::FloatAttr::get(type, *value);
+                }
+                case attr_code::strlit: {
+                    // the value is stored already escaped
+                    string_ref value;
+                    if (mlir::failed(reader.readString(value))) {
+                        return {};
+                    }
+
+                    return StringLiteralAttr::get(ctx, value, type);
+                }
+                case attr_code::strlit_resource: {
+                    auto handle = reader.readResourceHandle< mlir::DenseResourceElementsHandle >();
+                    if (mlir::failed(handle)) {
+                        return {};
+                    }
+
+                    return StringLiteralResourceAttr::get(type, *handle);
+                }
+                case attr_code::void_value:
+                    return VoidAttr::get(ctx, type);
+                case attr_code::source_language: {
+                    std::uint64_t value;
+                    if (mlir::failed(reader.readVarInt(value))) {
+                        return {};
+                    }
+
+                    if (auto lang = symbolizeSourceLanguage(static_cast< std::uint32_t >(value))) {
+                        return SourceLanguageAttr::get(ctx, *lang);
+                    }
+
+                    reader.emitError() << "invalid source language: " << value;
+                    return {};
+                }
+            }
+
+            reader.emitError() << "unknown core attribute code: " << static_cast< std::uint64_t >(code);
+            return {};
+        }
+
+    } // namespace
+
+    struct CoreBytecodeDialectInterface : mlir::BytecodeDialectInterface
+    {
+        using mlir::BytecodeDialectInterface::BytecodeDialectInterface;
+
+        mlir_attr readAttribute(reader_t &reader) const final {
+            std::uint64_t code;
+            if (mlir::failed(reader.readVarInt(code))) {
+                return {};
+            }
+
+            return read_attr(static_cast< attr_code >(code), getContext(), reader);
+        }
+
+        logical_result writeAttribute(mlir_attr attr, writer_t &writer) const final {
+            return llvm::TypeSwitch< mlir_attr, logical_result >(attr)
+                .Case([&] (BooleanAttr attr) {
+                    write_code(attr_code::boolean, writer);
+                    writer.writeType(attr.getType());
+                    writer.writeVarInt(attr.getValue());
+                    return mlir::success();
+                })
+                .Case([&] (core::IntegerAttr attr) {
+                    write_code(attr_code::integer, writer);
+                    writer.writeType(attr.getType());
+                    write_apsint(attr.getValue(), writer);
+                    return mlir::success();
+                })
+                .Case([&] (core::FloatAttr attr) {
+                    write_code(attr_code::floating, writer);
+                    writer.writeType(attr.getType());
+                    write_apfloat(attr.getValue(), writer);
+                    return mlir::success();
+                })
+                .Case([&] (StringLiteralAttr attr) {
+                    write_code(attr_code::strlit, writer);
+                    writer.writeType(attr.getType());
+                    writer.writeOwnedString(attr.getValue());
+                    return mlir::success();
+                })
+                .Case([&] (StringLiteralResourceAttr attr) {
+                    write_code(attr_code::strlit_resource, writer);
+                    writer.writeType(attr.getType());
+                    writer.writeResourceHandle(attr.getHandle());
+                    return mlir::success();
+                })
+                .Case([&] (VoidAttr attr) {
+                    write_code(attr_code::void_value, writer);
+                    writer.writeType(attr.getType());
+                    return mlir::success();
+                })
+                .Case([&] (SourceLanguageAttr attr) {
+                    write_code(attr_code::source_language, writer);
+                    writer.writeVarInt(static_cast< std::uint64_t >(attr.getValue()));
+                    return mlir::success();
+                })
+                .Default([] (auto) { return mlir::failure(); });
+        }
+
+        mlir_type readType(reader_t &reader) const final {
+            std::uint64_t code;
+            if (mlir::failed(reader.readVarInt(code))) {
+                return {};
+            }
+
+            if (code != static_cast< std::uint64_t >(type_code::function)) {
+                reader.emitError() << "unknown core type code: " << code;
+                return {};
+            }
+
+            auto read = [&] (mlir_type &type) { return reader.readType(type); };
+
+            llvm::SmallVector< mlir_type > inputs, results;
+            std::uint64_t vararg;
+            if (mlir::failed(reader.readList(inputs, read))
+                || mlir::failed(reader.readList(results, read))
+                || mlir::failed(reader.readVarInt(vararg)))
+            {
+                return {};
+            }
+
+            return FunctionType::get(getContext(), inputs, results, vararg);
+        }
+
+        logical_result writeType(mlir_type type, writer_t &writer) const final {
+            if (auto fn = mlir::dyn_cast< FunctionType >(type)) {
+                auto write = [&] (mlir_type type) { writer.writeType(type); };
+
+                write_code(type_code::function, writer);
+                writer.writeList(fn.getInputs(), write);
+                writer.writeList(fn.getResults(), write);
+                writer.writeVarInt(fn.getVarArg());
+                return mlir::success();
+            }
+
+            return mlir::failure();
+        }
+    };
+
+    void add_bytecode_interface(CoreDialect *dialect) {
+        dialect->addInterfaces< CoreBytecodeDialectInterface >();
+    }
+
+} // namespace vast::core
@@ -63,6 +63,7 @@ namespace vast::core
         >();
 
         addInterfaces< CoreOpAsmDialectInterface >();
+        add_bytecode_interface(this);
     }
 
     using OpBuilder = mlir::OpBuilder;
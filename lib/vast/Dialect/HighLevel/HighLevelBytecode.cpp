@@ -0,0 +1,270 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Bytecode/BytecodeImplementation.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelAttributes.hpp"
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "vast/Util/Common.hpp"
+#include "vast/Util/TypeList.hpp"
+
+#include <utility>
+
+namespace vast::hl
+{
+    namespace
+    {
+        //
+        // Types with a dedicated bytecode encoding. The position of a type in
+        // the list is its code in bytecode, therefore new types have to be
+        // appended to keep the existing bytecode readable. Other types fall
+        // back to their textual form.
+        //
+        using bytecode_types = util::type_list<
+            RecordType, EnumType, TypedefType, ElaboratedType, LabelType, ParenType,
+            LValueType, RValueType, VoidType, BoolType,
+            CharType, ShortType, IntType, LongType, LongLongType, Int128Type,
+            HalfType, BFloat16Type, FloatType, DoubleType, LongDoubleType, Float128Type,
+            PointerType, ArrayType, DecayedType, AttributedType, AdjustedType, ReferenceType,
+            TypeOfExprType, TypeOfTypeType
+        >;
+
+        using reader_t = mlir::DialectBytecodeReader;
+        using writer_t = mlir::DialectBytecodeWriter;
+
+        //
+        // Qualifiers are encoded as a bitmask, the lowest bit distinguishes
+        // a missing qualifiers attribute from an attribute without any
+        // qualifier set.
+        //
+        enum qualifier_bits : std::uint64_t {
+            present_bit  = 1 << 0,
+            const_bit    = 1 << 1,
+            volatile_bit = 1 << 2,
+            restrict_bit = 1 << 3,
+            unsigned_bit = 1 << 4
+        };
+
+        template< typename attr_t >
+        void write_quals(attr_t quals, writer_t &writer) {
+            std::uint64_t bits = 0;
+            if (quals) {
+                bits |= present_bit;
+                bits |= quals.getIsConst() ? const_bit : 0;
+                bits |= quals.getIsVolatile() ? volatile_bit : 0;
+                if constexpr (std::is_same_v< attr_t, CVRQualifiersAttr >) {
+                    bits |= quals.getIsRestrict() ? restrict_bit : 0;
+                }
+                if constexpr (std::is_same_v< attr_t, UCVQualifiersAttr >) {
+                    bits |= quals.getIsUnsigned() ? unsigned_bit : 0;
+                }
+            }
+
+            writer.writeVarInt(bits);
+        }
+
+        template< typename attr_t >
+        logical_result read_quals(mcontext_t *ctx, reader_t &reader, attr_t &quals) {
+            std::uint64_t bits = 0;
+            if (mlir::failed(reader.readVarInt(bits))) {
+                return mlir::failure();
+            }
+
+            if (!(bits & present_bit)) {
+                quals = {};
+                return mlir::success();
+            }
+
+            bool is_const    = bits & const_bit;
+            bool is_volatile = bits & volatile_bit;
+            if constexpr (std::is_same_v< attr_t, CVQualifiersAttr >) {
+                quals = attr_t::get(ctx, is_const, is_volatile);
+            } else if constexpr (std::is_same_v< attr_t, CVRQualifiersAttr >) {
+                quals = attr_t::get(ctx, is_const, is_volatile, bool(bits & restrict_bit));
+            } else {
+                static_assert(std::is_same_v< attr_t, UCVQualifiersAttr >);
+                quals = attr_t::get(ctx, bool(bits & unsigned_bit), is_const, is_volatile);
+            }
+
+            return mlir::success();
+        }
+
+        template< typename type_t >
+        using quals_t = decltype(std::declval< type_t >().getQuals());
+
+        template< typename type_t >
+        concept named_type = requires (type_t type) { type.getName(); };
+
+        template< typename type_t >
+        concept qualified_type = requires (type_t type) { type.getQuals(); };
+
+        template< typename type_t >
+        concept wrapping_type = requires (type_t type) { type.getElementType(); }
+            || std::is_same_v< type_t, TypeOfTypeType >;
+
+        mlir_type wrapped(auto type) {
+            if constexpr (std::is_same_v< decltype(type), TypeOfTypeType >) {
+                return type.getUnmodifiedType();
+            } else {
+                return type.getElementType();
+            }
+        }
+
+        // Array size is shifted by one to encode the unknown size as zero.
+        std::uint64_t encode_size(SizeParam size) { return size ? *size + 1 : 0; }
+
+        SizeParam decode_size(std::uint64_t size) {
+            return size ? SizeParam(size - 1) : unknown_size;
+        }
+
+        //
+        // Parameters are written in the order of the type builder.
+        //
+        template< typename type_t >
+        void write_params(type_t type, writer_t &writer) {
+            if constexpr (std::is_same_v< type_t, ArrayType >) {
+                writer.writeVarInt(encode_size(type.getSize()));
+            }
+
+            if constexpr (std::is_same_v< type_t, AdjustedType >) {
+                writer.writeType(type.getOriginal());
+                writer.writeType(type.getAdjusted());
+            }
+
+            if constexpr (named_type< type_t >) {
+                writer.writeOwnedString(type.getName());
+            }
+
+            if constexpr (wrapping_type< type_t >) {
+                writer.writeType(wrapped(type));
+            }
+
+            if constexpr (qualified_type< type_t >) {
+                write_quals(type.getQuals(), writer);
+            }
+        }
+
+        template< typename type_t >
+        mlir_type read_params(mcontext_t *ctx, reader_t &reader) {
+            if constexpr (std::is_same_v< type_t, ArrayType >) {
+                std::uint64_t size;
+                mlir_type element;
+                quals_t< type_t > quals;
+                if (mlir::failed(reader.readVarInt(size)) || mlir::failed(reader.readType(element))
+                    || mlir::failed(read_quals(ctx, reader, quals)))
+                {
+                    return {};
+                }
+
+                return type_t::get(ctx, decode_size(size), element, quals);
+            } else if constexpr (std::is_same_v< type_t, AdjustedType >) {
+                mlir_type original, adjusted;
+                if (mlir::failed(reader.readType(original)) || mlir::failed(reader.readType(adjusted))) {
+                    return {};
+                }
+
+                return type_t::get(ctx, original, adjusted);
+            } else if constexpr (named_type< type_t >) {
+                string_ref name;
+                quals_t< type_t > quals;
+                if (mlir::failed(reader.readString(name)) || mlir::failed(read_quals(ctx, reader, quals))) {
+                    return {};
+                }
+
+                return type_t::get(ctx, name, quals);
+            } else if constexpr (wrapping_type< type_t > && qualified_type< type_t >) {
+                mlir_type element;
+                quals_t< type_t > quals;
+                if (mlir::failed(reader.readType(element)) || mlir::failed(read_quals(ctx, reader, quals))) {
+                    return {};
+                }
+
+                return type_t::get(ctx, element, quals);
+            } else if constexpr (wrapping_type< type_t >) {
+                mlir_type element;
+                if (mlir::failed(reader.readType(element))) {
+                    return {};
+                }
+
+                return type_t::get(ctx, element);
+            } else if constexpr (qualified_type< type_t >) {
+                quals_t< type_t > quals;
+                if (mlir::failed(read_quals(ctx, reader, quals))) {
+                    return {};
+                }
+
+                return type_t::get(ctx, quals);
+            } else {
+                return type_t::get(ctx);
+            }
+        }
+
+        template< std::size_t... codes >
+        logical_result write_type(mlir_type type, writer_t &writer, std::index_sequence< codes... >) {
+            auto write = [&] < std::size_t code > () {
+                using type_t = typename bytecode_types::template at< code >;
+                if (auto ty = mlir::dyn_cast< type_t >(type)) {
+                    writer.writeVarInt(code);
+                    write_params(ty, writer);
+                    return true;
+                }
+
+                return false;
+            };
+
+            return mlir::success((write.template operator()< codes >() || ...));
+        }
+
+        template< std::size_t... codes >
+        mlir_type read_type(
+            std::uint64_t code, mcontext_t *ctx, reader_t &reader, std::index_sequence< codes... >
+        ) {
+            mlir_type result;
+            auto read = [&] < std::size_t current > () {
+                if (code != current) {
+                    return false;
+                }
+
+                result = read_params< typename bytecode_types::template at< current > >(ctx, reader);
+                return true;
+            };
+
+            if (!(read.template operator()< codes >() || ...)) {
+                reader.emitError() << "unknown high-level type code: " << code;
+            }
+
+            return result;
+        }
+
+        using type_codes = std::make_index_sequence< bytecode_types::size >;
+
+    } // namespace
+
+    struct HighLevelBytecodeDialectInterface : mlir::BytecodeDialectInterface
+    {
+        using mlir::BytecodeDialectInterface::BytecodeDialectInterface;
+
+        mlir_type readType(reader_t &reader) const final {
+            std::uint64_t code;
+            if (mlir::failed(reader.readVarInt(code))) {
+                return {};
+            }
+
+            return read_type(code, getContext(), reader, type_codes{});
+        }
+
+        logical_result writeType(mlir_type type, writer_t &writer) const final {
+            return write_type(type, writer, type_codes{});
+        }
+    };
+
+    void add_bytecode_interface(HighLevelDialect *dialect) {
+        dialect->addInterfaces< HighLevelBytecodeDialectInterface >();
+    }
+
+} // namespace vast::hl
@@ -0,0 +1,693 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/Matchers.h>
+#include <mlir/IR/OpDefinition.h>
+
+#include <llvm/ADT/APFloat.h>
+#include <llvm/ADT/APInt.h>
+#include <llvm/ADT/APSInt.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "vast/Dialect/Core/CoreAttributes.hpp"
+
+#include "vast/Util/Common.hpp"
+#include "vast/Util/DataLayout.hpp"
+#include "vast/Util/Region.hpp"
+
+#include <optional>
+
+// Constant folding of high-level operations.
+//
+// Folders follow C semantics of the operation result type: unsigned integer
+// arithmetic wraps at the width given by the module data layout, and anything
+// that would be undefined behaviour at runtime (division by zero, signed
+// overflow, out of range shifts or float to integer conversions) is left
+// unfolded. Types that can not be resolved locally (e.g., typedefs or enums)
+// are never folded.
+namespace vast::hl
+{
+    using FoldResult = mlir::OpFoldResult;
+
+    namespace
+    {
+        struct int_semantics
+        {
+            unsigned bw;
+            bool is_signed;
+        };
+
+        std::optional< unsigned > bitwidth(mlir_type type, operation op) {
+            if (auto int_type = mlir::dyn_cast< mlir::IntegerType >(type))
+                return int_type.getWidth();
+
+            auto mod = op->getParentOfType< vast_module >();
+            if (!mod)
+                return std::nullopt;
+
+            auto spec = mod.getDataLayoutSpec();
+            if (!spec)
+                return std::nullopt;
+
+            for (auto entry : spec.getEntries()) {
+                if (mlir::dyn_cast< mlir_type >(entry.getKey()) != type)
+                    continue;
+                if (!mlir::isa< mlir::DictionaryAttr >(entry.getValue()))
+                    return std::nullopt;
+                return dl::DLEntry(entry).bw;
+            }
+
+            return std::nullopt;
+        }
+
+        std::optional< int_semantics > integer_semantics(mlir_type type, operation op) {
+            if (!isBoolType(type) && !isIntegerType(type) && !mlir::isa< mlir::IntegerType >(type))
+                return std::nullopt;
+
+            if (auto bw = bitwidth(type, op))
+                return int_semantics{ *bw, isSigned(type) };
+            return std::nullopt;
+        }
+
+        const llvm::fltSemantics *float_semantics(mlir_type type) {
+            if (isFloatingType(type))
+                return &mlir::cast< mlir::FloatType >(to_std_float_type(type)).getFloatSemantics();
+            if (auto float_type = mlir::dyn_cast< mlir::FloatType >(type))
+                return &float_type.getFloatSemantics();
+            return nullptr;
+        }
+
+        // Codegen does not keep the width and signedness of integer attributes
+        // in sync with their type, therefore values are always normalized to
+        // the semantics of the type they are used with.
+        std::optional< ap_int > get_integer(mlir::Attribute attr, int_semantics sem) {
+            if (auto int_attr = mlir::dyn_cast_or_null< core::IntegerAttr >(attr))
+                return int_attr.getValue().extOrTrunc(sem.bw);
+            if (auto bool_attr = mlir::dyn_cast_or_null< core::BooleanAttr >(attr))
+                return ap_int(sem.bw, bool_attr.getValue());
+            return std::nullopt;
+        }
+
+        std::optional< ap_float > get_float(mlir::Attribute attr) {
+            if (auto float_attr = mlir::dyn_cast_or_null< core::FloatAttr >(attr))
+                return float_attr.getValue();
+            return std::nullopt;
+        }
+
+        // Interprets a constant as a C condition.
+        std::optional< bool > get_truth(mlir::Attribute attr) {
+            if (auto bool_attr = mlir::dyn_cast_or_null< core::BooleanAttr >(attr))
+                return bool_attr.getValue();
+            if (auto int_attr = mlir::dyn_cast_or_null< core::IntegerAttr >(attr))
+                return !int_attr.getValue().isZero();
+            if (auto float_attr = mlir::dyn_cast_or_null< core::FloatAttr >(attr))
+                return !float_attr.getValue().isZero();
+            return std::nullopt;
+        }
+
+        mlir::Attribute make_integer(mlir_type type, const ap_int &value, int_semantics sem) {
+            if (isBoolType(type))
+                return core::BooleanAttr::get(type, !value.isZero());
+            return core::IntegerAttr::get(type, ap_sint(value, !sem.is_signed));
+        }
+
+        mlir::Attribute make_truth(mlir_type type, bool value, operation op) {
+            if (isBoolType(type))
+                return core::BooleanAttr::get(type, value);
+            if (auto sem = integer_semantics(type, op))
+                return make_integer(type, ap_int(sem->bw, value), *sem);
+            return {};
+        }
+
+        using int_binary_fn = std::optional< ap_int > (*)(const ap_int &, const ap_int &);
+
+        // Operations whose result depends on the signedness of the operands,
+        // e.g., signed overflow is undefined behaviour, unsigned one wraps.
+        using int_signed_binary_fn = std::optional< ap_int > (*)(
+            const ap_int &, const ap_int &, bool /* is_signed */
+        );
+
+        template< typename op_t >
+        FoldResult fold_int_binary_impl(op_t op, mlir::Attribute lhs, mlir::Attribute rhs, auto &&fn) {
+            auto type = op.getType();
+            if (op.getLhs().getType() != type || op.getRhs().getType() != type)
+                return {};
+
+            auto sem = integer_semantics(type, op);
+            if (!sem)
+                return {};
+
+            auto l = get_integer(lhs, *sem);
+            auto r = get_integer(rhs, *sem);
+            if (!l || !r)
+                return {};
+
+            if (auto res = fn(*l, *r, sem->is_signed))
+                return make_integer(type, *res, *sem);
+            return {};
+        }
+
+        template< typename op_t >
+        FoldResult fold_int_binary(op_t op, mlir::Attribute lhs, mlir::Attribute rhs, int_binary_fn fn) {
+            return fold_int_binary_impl(op, lhs, rhs, [fn] (const ap_int &l, const ap_int &r, bool) {
+                return fn(l, r);
+            });
+        }
+
+        template< typename op_t >
+        FoldResult fold_int_binary(op_t op, mlir::Attribute lhs, mlir::Attribute rhs, int_signed_binary_fn fn) {
+            return fold_int_binary_impl(op, lhs, rhs, fn);
+        }
+
+        // Folds `x op c` to `x` when `c` is the right identity of the operation.
+        template< typename op_t >
+        FoldResult fold_right_identity(op_t op, mlir::Attribute rhs, uint64_t identity) {
+            auto type = op.getType();
+            if (op.getLhs().getType() != type || isBoolType(type))
+                return {};
+
+            auto sem = integer_semantics(op.getRhs().getType(), op);
+            if (!sem)
+                return {};
+
+            if (auto r = get_integer(rhs, *sem); r && *r == identity)
+                return mlir_value(op.getLhs());
+            return {};
+        }
+
+        using float_binary_fn = ap_float (*)(const ap_float &, const ap_float &);
+
+        template< typename op_t >
+        FoldResult fold_float_binary(op_t op, mlir::Attribute lhs, mlir::Attribute rhs, float_binary_fn fn) {
+            auto type = op.getType();
+            if (op.getLhs().getType() != type || op.getRhs().getType() != type)
+                return {};
+
+            auto sem = float_semantics(type);
+            auto l = get_float(lhs);
+            auto r = get_float(rhs);
+            if (!sem || !l || !r)
+                return {};
+
+            if (&l->getSemantics() != sem || &r->getSemantics() != sem)
+                return {};
+
+            return core::FloatAttr::get(type, fn(*l, *r));
+        }
+
+        template< typename op_t >
+        FoldResult fold_shift(op_t op, mlir::Attribute lhs, mlir::Attribute rhs, int_signed_binary_fn fn) {
+            auto type = op.getType();
+            if (op.getLhs().getType() != type)
+                return {};
+
+            auto lsem = integer_semantics(type, op);
+            auto rsem = integer_semantics(op.getRhs().getType(), op);
+            if (!lsem || !rsem)
+                return {};
+
+            auto r = get_integer(rhs, *rsem);
+            if (!r)
+                return {};
+
+            // Negative and too large shift amounts are undefined behaviour.
+            if ((rsem->is_signed && r->isNegative()) || r->uge(lsem->bw))
+                return {};
+
+            if (r->isZero())
+                return mlir_value(op.getLhs());
+
+            auto l = get_integer(lhs, *lsem);
+            if (!l)
+                return {};
+
+            auto amount = ap_int(lsem->bw, r->getZExtValue());
+            if (auto res = fn(*l, amount, lsem->is_signed))
+                return make_integer(type, *res, *lsem);
+            return {};
+        }
+
+        bool evaluate(Predicate pred, const ap_int &lhs, const ap_int &rhs) {
+            switch (pred) {
+                case Predicate::eq:  return lhs.eq(rhs);
+                case Predicate::ne:  return lhs.ne(rhs);
+                case Predicate::slt: return lhs.slt(rhs);
+                case Predicate::sle: return lhs.sle(rhs);
+                case Predicate::sgt: return lhs.sgt(rhs);
+                case Predicate::sge: return lhs.sge(rhs);
+                case Predicate::ult: return lhs.ult(rhs);
+                case Predicate::ule: return lhs.ule(rhs);
+                case Predicate::ugt: return lhs.ugt(rhs);
+                case Predicate::uge: return lhs.uge(rhs);
+            }
+            VAST_UNREACHABLE("unknown comparison predicate");
+        }
+
+        bool evaluate(FPredicate pred, const ap_float &lhs, const ap_float &rhs) {
+            using cmp = ap_float::cmpResult;
+            auto res = lhs.compare(rhs);
+            switch (pred) {
+                case FPredicate::ffalse: return false;
+                case FPredicate::oeq: return res == cmp::cmpEqual;
+                case FPredicate::ogt: return res == cmp::cmpGreaterThan;
+                case FPredicate::oge: return res == cmp::cmpGreaterThan || res == cmp::cmpEqual;
+                case FPredicate::olt: return res == cmp::cmpLessThan;
+                case FPredicate::ole: return res == cmp::cmpLessThan || res == cmp::cmpEqual;
+                case FPredicate::one: return res != cmp::cmpUnordered && res != cmp::cmpEqual;
+                case FPredicate::ord: return res != cmp::cmpUnordered;
+                case FPredicate::uno: return res == cmp::cmpUnordered;
+                case FPredicate::ueq: return res == cmp::cmpUnordered || res == cmp::cmpEqual;
+                case FPredicate::ugt: return res == cmp::cmpUnordered || res == cmp::cmpGreaterThan;
+                case FPredicate::uge: return res != cmp::cmpLessThan;
+                case FPredicate::ult: return res == cmp::cmpUnordered || res == cmp::cmpLessThan;
+                case FPredicate::ule: return res != cmp::cmpGreaterThan;
+                case FPredicate::une: return res != cmp::cmpEqual;
+                case FPredicate::ftrue: return true;
+            }
+            VAST_UNREACHABLE("unknown floating point comparison predicate");
+        }
+
+        // Returns the constant yielded from a value region, that consists
+        // solely of constants, i.e., its evaluation has no side effects.
+        mlir::Attribute get_constant_yield(Region &region) {
+            if (!region.hasOneBlock())
+                return {};
+
+            for (auto &op : region.front().without_terminator())
+                if (!op.hasTrait< mlir::OpTrait::ConstantLike >())
+                    return {};
+
+            mlir::Attribute attr;
+            if (auto value = get_maybe_yielded_value(region))
+                mlir::matchPattern(value, mlir::m_Constant(&attr));
+            return attr;
+        }
+
+        template< typename op_t >
+        FoldResult fold_cast(op_t op, mlir::Attribute value) {
+            auto from = op.getValue().getType();
+            auto to   = op.getType();
+
+            auto as_integer = [&] () -> std::optional< ap_int > {
+                if (auto sem = integer_semantics(from, op))
+                    return get_integer(value, *sem);
+                return std::nullopt;
+            };
+
+            switch (op.getKind()) {
+                case CastKind::NoOp: {
+                    if (from == to)
+                        return mlir_value(op.getValue());
+                    return {};
+                }
+
+                case CastKind::IntegralCast: {
+                    auto fsem = integer_semantics(from, op);
+                    auto tsem = integer_semantics(to, op);
+                    auto v = as_integer();
+                    if (!fsem || !tsem || !v)
+                        return {};
+                    auto res = fsem->is_signed ? v->sextOrTrunc(tsem->bw) : v->zextOrTrunc(tsem->bw);
+                    return make_integer(to, res, *tsem);
+                }
+
+                case CastKind::IntegralToBoolean:
+                case CastKind::FloatingToBoolean: {
+                    if (auto truth = get_truth(value))
+                        return make_truth(to, *truth, op);
+                    return {};
+                }
+
+                case CastKind::BooleanToSignedIntegral: {
+                    auto tsem = integer_semantics(to, op);
+                    auto truth = get_truth(value);
+                    if (!tsem || !truth)
+                        return {};
+                    auto res = *truth ? ap_int::getAllOnes(tsem->bw) : ap_int::getZero(tsem->bw);
+                    return make_integer(to, res, *tsem);
+                }
+
+                case CastKind::IntegralToFloating: {
+                    auto fsem = integer_semantics(from, op);
+                    auto tsem = float_semantics(to);
+                    auto v = as_integer();
+                    if (!fsem || !tsem || !v)
+                        return {};
+                    auto res = ap_float(*tsem);
+                    auto status = res.convertFromAPInt(*v, fsem->is_signed, ap_float::rmNearestTiesToEven);
+                    if (status & ap_float::opOverflow)
+                        return {};
+                    return core::FloatAttr::get(to, res);
+                }
+
+                case CastKind::FloatingToIntegral: {
+                    auto tsem = integer_semantics(to, op);
+                    auto v = get_float(value);
+                    if (!tsem || !v || isBoolType(to))
+                        return {};
+                    auto res = ap_sint(tsem->bw, !tsem->is_signed);
+                    bool exact = false;
+                    auto status = v->convertToInteger(res, ap_float::rmTowardZero, &exact);
+                    // Out of range conversions are undefined behaviour.
+                    if (status & ap_float::opInvalidOp)
+                        return {};
+                    return make_integer(to, res, *tsem);
+                }
+
+                case CastKind::FloatingCast: {
+                    auto tsem = float_semantics(to);
+                    auto v = get_float(value);
+                    if (!tsem || !v)
+                        return {};
+                    bool loses_info = false;
+                    auto status = v->convert(*tsem, ap_float::rmNearestTiesToEven, &loses_info);
+                    // Out of range conversions are undefined behaviour.
+                    if (status & ap_float::opOverflow)
+                        return {};
+                    return core::FloatAttr::get(to, *v);
+                }
+
+                default:
+                    return {};
+            }
+        }
+
+    } // namespace
+
+    //===----------------------------------------------------------------------===//
+    // Arithmetic operations
+    //===----------------------------------------------------------------------===//
+
+    FoldResult AddIOp::fold(FoldAdaptor adaptor) {
+        if (auto res = fold_right_identity(*this, adaptor.getRhs(), 0))
+            return res;
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r, bool is_signed) -> std::optional< ap_int > {
+                bool overflow = false;
+                auto res = is_signed ? l.sadd_ov(r, overflow) : l + r;
+                if (overflow)
+                    return std::nullopt;
+                return res;
+            }
+        );
+    }
+
+    FoldResult SubIOp::fold(FoldAdaptor adaptor) {
+        if (auto res = fold_right_identity(*this, adaptor.getRhs(), 0))
+            return res;
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r, bool is_signed) -> std::optional< ap_int > {
+                bool overflow = false;
+                auto res = is_signed ? l.ssub_ov(r, overflow) : l - r;
+                if (overflow)
+                    return std::nullopt;
+                return res;
+            }
+        );
+    }
+
+    FoldResult MulIOp::fold(FoldAdaptor adaptor) {
+        if (auto res = fold_right_identity(*this, adaptor.getRhs(), 1))
+            return res;
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r, bool is_signed) -> std::optional< ap_int > {
+                bool overflow = false;
+                auto res = is_signed ? l.smul_ov(r, overflow) : l * r;
+                if (overflow)
+                    return std::nullopt;
+                return res;
+            }
+        );
+    }
+
+    FoldResult DivSOp::fold(FoldAdaptor adaptor) {
+        if (auto res = fold_right_identity(*this, adaptor.getRhs(), 1))
+            return res;
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r) -> std::optional< ap_int > {
+                bool overflow = false;
+                if (r.isZero())
+                    return std::nullopt;
+                auto res = l.sdiv_ov(r, overflow);
+                if (overflow)
+                    return std::nullopt;
+                return res;
+            }
+        );
+    }
+
+    FoldResult DivUOp::fold(FoldAdaptor adaptor) {
+        if (auto res = fold_right_identity(*this, adaptor.getRhs(), 1))
+            return res;
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r) -> std::optional< ap_int > {
+                if (r.isZero())
+                    return std::nullopt;
+                return l.udiv(r);
+            }
+        );
+    }
+
+    FoldResult RemSOp::fold(FoldAdaptor adaptor) {
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r) -> std::optional< ap_int > {
+                // `INT_MIN % -1` is undefined as `INT_MIN / -1` overflows.
+                if (r.isZero() || (l.isMinSignedValue() && r.isAllOnes()))
+                    return std::nullopt;
+                return l.srem(r);
+            }
+        );
+    }
+
+    FoldResult RemUOp::fold(FoldAdaptor adaptor) {
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r) -> std::optional< ap_int > {
+                if (r.isZero())
+                    return std::nullopt;
+                return l.urem(r);
+            }
+        );
+    }
+
+    FoldResult AddFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_float &l, const ap_float &r) { return l + r; }
+        );
+    }
+
+    FoldResult SubFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_float &l, const ap_float &r) { return l - r; }
+        );
+    }
+
+    FoldResult MulFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_float &l, const ap_float &r) { return l * r; }
+        );
+    }
+
+    FoldResult DivFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_float &l, const ap_float &r) { return l / r; }
+        );
+    }
+
+    FoldResult RemFOp::fold(FoldAdaptor adaptor) {
+        return fold_float_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_float &l, const ap_float &r) {
+                auto res = l;
+                res.mod(r);
+                return res;
+            }
+        );
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Bitwise operations
+    //===----------------------------------------------------------------------===//
+
+    FoldResult BinXorOp::fold(FoldAdaptor adaptor) {
+        if (auto res = fold_right_identity(*this, adaptor.getRhs(), 0))
+            return res;
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r) -> std::optional< ap_int > { return l ^ r; }
+        );
+    }
+
+    FoldResult BinOrOp::fold(FoldAdaptor adaptor) {
+        if (auto res = fold_right_identity(*this, adaptor.getRhs(), 0))
+            return res;
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r) -> std::optional< ap_int > { return l | r; }
+        );
+    }
+
+    FoldResult BinAndOp::fold(FoldAdaptor adaptor) {
+        return fold_int_binary(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r) -> std::optional< ap_int > { return l & r; }
+        );
+    }
+
+    FoldResult BinShlOp::fold(FoldAdaptor adaptor) {
+        return fold_shift(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r, bool is_signed) -> std::optional< ap_int > {
+                if (!is_signed)
+                    return l.shl(r);
+                // Shifting a negative value or out of the range is undefined.
+                bool overflow = false;
+                auto res = l.sshl_ov(r, overflow);
+                if (l.isNegative() || overflow)
+                    return std::nullopt;
+                return res;
+            }
+        );
+    }
+
+    FoldResult BinLShrOp::fold(FoldAdaptor adaptor) {
+        return fold_shift(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r, bool) -> std::optional< ap_int > { return l.lshr(r); }
+        );
+    }
+
+    FoldResult BinAShrOp::fold(FoldAdaptor adaptor) {
+        return fold_shift(*this, adaptor.getLhs(), adaptor.getRhs(),
+            [] (const ap_int &l, const ap_int &r, bool) -> std::optional< ap_int > { return l.ashr(r); }
+        );
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Logical operations
+    //===----------------------------------------------------------------------===//
+
+    FoldResult BinLAndOp::fold(FoldAdaptor) {
+        auto lhs = get_truth(get_constant_yield(getLhs()));
+        if (!lhs)
+            return {};
+        if (!*lhs)
+            return make_truth(getType(), false, *this);
+        if (auto rhs = get_truth(get_constant_yield(getRhs())))
+            return make_truth(getType(), *rhs, *this);
+        return {};
+    }
+
+    FoldResult BinLOrOp::fold(FoldAdaptor) {
+        auto lhs = get_truth(get_constant_yield(getLhs()));
+        if (!lhs)
+            return {};
+        if (*lhs)
+            return make_truth(getType(), true, *this);
+        if (auto rhs = get_truth(get_constant_yield(getRhs())))
+            return make_truth(getType(), *rhs, *this);
+        return {};
+    }
+
+    FoldResult LNotOp::fold(FoldAdaptor adaptor) {
+        if (auto truth = get_truth(adaptor.getArg()))
+            return make_truth(getType(), !*truth, *this);
+        return {};
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Comparisons
+    //===----------------------------------------------------------------------===//
+
+    FoldResult CmpOp::fold(FoldAdaptor adaptor) {
+        auto type = getLhs().getType();
+        if (getRhs().getType() != type)
+            return {};
+
+        auto sem = integer_semantics(type, *this);
+        if (!sem)
+            return {};
+
+        auto lhs = get_integer(adaptor.getLhs(), *sem);
+        auto rhs = get_integer(adaptor.getRhs(), *sem);
+        if (!lhs || !rhs)
+            return {};
+
+        return make_truth(getType(), evaluate(getPredicate(), *lhs, *rhs), *this);
+    }
+
+    FoldResult FCmpOp::fold(FoldAdaptor adaptor) {
+        auto lhs = get_float(adaptor.getLhs());
+        auto rhs = get_float(adaptor.getRhs());
+        if (!lhs || !rhs || &lhs->getSemantics() != &rhs->getSemantics())
+            return {};
+
+        return make_truth(getType(), evaluate(getPredicate(), *lhs, *rhs), *this);
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Unary operations
+    //===----------------------------------------------------------------------===//
+
+    FoldResult PlusOp::fold(FoldAdaptor) {
+        return mlir_value(getArg());
+    }
+
+    FoldResult MinusOp::fold(FoldAdaptor adaptor) {
+        auto type = getType();
+        if (auto v = get_float(adaptor.getArg())) {
+            v->changeSign();
+            return core::FloatAttr::get(type, *v);
+        }
+
+        auto sem = integer_semantics(type, *this);
+        if (!sem || isBoolType(type))
+            return {};
+
+        if (auto v = get_integer(adaptor.getArg(), *sem)) {
+            if (!sem->is_signed) {
+                v->negate();
+                return make_integer(type, *v, *sem);
+            }
+
+            // Negation of the minimal signed value overflows.
+            bool overflow = false;
+            auto res = llvm::APInt::getZero(sem->bw).ssub_ov(*v, overflow);
+            if (overflow)
+                return {};
+            return make_integer(type, res, *sem);
+        }
+        return {};
+    }
+
+    FoldResult NotOp::fold(FoldAdaptor adaptor) {
+        auto type = getType();
+        auto sem = integer_semantics(type, *this);
+        if (!sem || isBoolType(type))
+            return {};
+
+        if (auto v = get_integer(adaptor.getArg(), *sem)) {
+            v->flipAllBits();
+            return make_integer(type, *v, *sem);
+        }
+        return {};
+    }
+
+    //===----------------------------------------------------------------------===//
+    // Casts
+    //===----------------------------------------------------------------------===//
+
+    FoldResult ImplicitCastOp::fold(FoldAdaptor adaptor) {
+        return fold_cast(*this, adaptor.getValue());
+    }
+
+    FoldResult CStyleCastOp::fold(FoldAdaptor adaptor) {
+        return fold_cast(*this, adaptor.getValue());
+    }
+
+    FoldResult BuiltinBitCastOp::fold(FoldAdaptor adaptor) {
+        if (getKind() == CastKind::NoOp && getValue().getType() == getType())
+            return mlir_value(getValue());
+        return {};
+    }
+
+} // namespace vast::hl
@@ -4,6 +4,7 @@
 #include "vast/Util/Warnings.hpp"
 
 VAST_RELAX_WARNINGS
+#include <mlir/IR/Matchers.h>
 #include <mlir/IR/PatternMatch.h>
 VAST_UNRELAX_WARNINGS
 
@@ -71,6 +72,77 @@ namespace vast::hl
                 run(&op, rewriter);
         }
 
+        // Replaces the results of `op` by folded values, constants are
+        // materialized right before `op`, so that they stay in the same
+        // (value) region as the folded operation.
+        bool replace_by_folded(operation op, llvm::ArrayRef< mlir::OpFoldResult > folded, rewriter_t &rewriter) {
+            auto g = rewriter.guard();
+            rewriter->setInsertionPoint(op);
+
+            llvm::SmallVector< mlir_value > values;
+            for (auto [result, fold] : llvm::zip(op->getResults(), folded)) {
+                if (auto value = fold.dyn_cast< mlir_value >()) {
+                    values.push_back(value);
+                    continue;
+                }
+
+                auto cst = op->getDialect()->materializeConstant(
+                    *rewriter, fold.get< mlir::Attribute >(), result.getType(), op->getLoc()
+                );
+
+                if (!cst) {
+                    // Do not leave half-materialized constants behind.
+                    for (auto value : values)
+                        if (auto def = value.getDefiningOp(); def && def->use_empty())
+                            def->erase();
+                    return false;
+                }
+
+                values.push_back(cst->getResult(0));
+            }
+
+            llvm::SmallVector< operation > operand_constants;
+            for (auto operand : op->getOperands())
+                if (auto cst = operand.getDefiningOp< hl::ConstantOp >())
+                    if (!llvm::is_contained(operand_constants, cst))
+                        operand_constants.push_back(cst);
+
+            op->replaceAllUsesWith(values);
+            op->erase();
+
+            // Constants used only by the folded operation are dead now. They
+            // are erased right away, a later fold may erase a region that
+            // contains them.
+            for (auto cst : operand_constants)
+                if (cst->use_empty())
+                    cst->erase();
+            return true;
+        }
+
+        // Folds operations with constant operands. Unlike the greedy pattern
+        // driver, this does not hoist constants out of value regions (e.g.,
+        // global initializers), and therefore keeps the structure of the hl
+        // dialect intact.
+        void fold_constants(operation root, rewriter_t &rewriter) {
+            llvm::SmallVector< mlir::Attribute > operands;
+            llvm::SmallVector< mlir::OpFoldResult > folded;
+
+            root->walk< mlir::WalkOrder::PostOrder >([&] (operation op) {
+                if (op->hasTrait< mlir::OpTrait::ConstantLike >() || op->getNumResults() == 0)
+                    return;
+
+                operands.assign(op->getNumOperands(), mlir::Attribute());
+                for (auto [idx, operand] : llvm::enumerate(op->getOperands()))
+                    mlir::matchPattern(operand, mlir::m_Constant(&operands[idx]));
+
+                folded.clear();
+                if (mlir::failed(op->fold(operands, folded)) || folded.empty())
+                    return;
+
+                replace_by_folded(op, folded, rewriter);
+            });
+        }
+
         void runOnOperation() override
         {
             auto op = getOperation();
@@ -81,6 +153,8 @@ namespace vast::hl
 
             for (auto op : to_remove)
                 op->erase();
+
+            fold_constants(op, bld);
         }
     };
 
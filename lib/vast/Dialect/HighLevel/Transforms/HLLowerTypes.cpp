@@ -291,6 +291,15 @@ namespace vast::hl {
                             return core::VoidAttr::get(type.getContext(), type);
                         })
                         .template take_wrapped< maybe_attr_t >();
+                } else if constexpr (std::same_as< attr_t, core::StringLiteralResourceAttr >) {
+                    return Maybe(typed.getType())
+                        .and_then([&] (auto type) {
+                            return getTypeConverter()->convertType(type);
+                        })
+                        .and_then([&] (auto type) {
+                            return attr_t::get(type, typed.getHandle());
+                        })
+                        .template take_wrapped< maybe_attr_t >();
                 } else {
                 return Maybe(typed.getType())
                     .and_then([&] (auto type) {
@@ -0,0 +1,157 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Dialect/HighLevel/Passes.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/IR/AttrTypeSubElements.h>
+
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/StringMap.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Util/Common.hpp"
+
+#include "vast/Dialect/HighLevel/HighLevelDialect.hpp"
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
+
+#include "vast/Interfaces/SymbolInterface.hpp"
+
+#include "PassesDetails.hpp"
+
+namespace vast::hl
+{
+    namespace
+    {
+        bool is_type_decl(operation op) {
+            return mlir::isa<
+                hl::TypeDeclOp, hl::TypeDefOp, hl::TypeOfExprOp, hl::EnumDeclOp,
+                hl::StructDeclOp, hl::UnionDeclOp, hl::CxxStructDeclOp, hl::ClassDeclOp
+            >(op);
+        }
+
+        // Returns the name of the declaration referenced by a named type.
+        std::optional< string_ref > referenced_decl_name(mlir_type type) {
+            return llvm::TypeSwitch< mlir_type, std::optional< string_ref > >(type)
+                .Case< hl::RecordType, hl::EnumType, hl::TypedefType, hl::TypeOfExprType >(
+                    [] (auto named) { return named.getName(); }
+                )
+                .Default([] (auto) { return std::nullopt; });
+        }
+
+    } // namespace
+
+    struct PruneUnusedTypes : PruneUnusedTypesBase< PruneUnusedTypes >
+    {
+        using base = PruneUnusedTypesBase< PruneUnusedTypes >;
+
+        using operations_t = std::vector< operation >;
+
+        // Global type declarations, that are candidates for removal.
+        operations_t candidates;
+        llvm::StringMap< llvm::SmallVector< operation, 1 > > decls;
+        llvm::StringMap< operation > enum_of_constant;
+
+        llvm::DenseSet< operation > live;
+        operations_t worklist;
+
+        void mark_live(operation decl) {
+            if (live.insert(decl).second)
+                worklist.push_back(decl);
+        }
+
+        void mark_live(string_ref name) {
+            if (auto it = decls.find(name); it != decls.end())
+                for (auto decl : it->second)
+                    mark_live(decl);
+        }
+
+        void collect_candidate(operation op) {
+            candidates.push_back(op);
+
+            auto name = mlir::cast< VastSymbolOpInterface >(op).getSymbolName();
+            decls[name].push_back(op);
+
+            if (auto enum_decl = mlir::dyn_cast< hl::EnumDeclOp >(op)) {
+                for (auto &con : enum_decl.getConstants().getOps())
+                    if (auto enum_const = mlir::dyn_cast< hl::EnumConstantOp >(con))
+                        enum_of_constant[enum_const.getName()] = op;
+            }
+        }
+
+        // Type declarations are only pruned from the global scope, nested
+        // declarations live and die together with their parent.
+        void collect_candidates(operation scope, operations_t &roots) {
+            for (auto &region : scope->getRegions()) {
+                for (auto &op : region.getOps()) {
+                    if (is_type_decl(&op))
+                        collect_candidate(&op);
+                    else if (mlir::isa< hl::TranslationUnitOp >(op))
+                        collect_candidates(&op, roots);
+                    else
+                        roots.push_back(&op);
+                }
+            }
+        }
+
+        // Marks everything that is referenced by `root` or any of its nested
+        // operations as live.
+        void scan(operation root, mlir::AttrTypeWalker &walker) {
+            root->walk([&] (operation op) {
+                for (auto type : op->getResultTypes())
+                    walker.walk(type);
+
+                walker.walk(op->getAttrDictionary());
+
+                for (auto &region : op->getRegions())
+                    for (auto &block : region)
+                        for (auto arg : block.getArgumentTypes())
+                            walker.walk(arg);
+
+                if (auto ref = mlir::dyn_cast< hl::EnumRefOp >(op)) {
+                    if (auto it = enum_of_constant.find(ref.getValue()); it != enum_of_constant.end())
+                        mark_live(it->second);
+                }
+            });
+        }
+
+        void runOnOperation() override
+        {
+            auto root = getOperation();
+
+            operations_t roots;
+            collect_candidates(root, roots);
+
+            // The walker caches already visited types and attributes, therefore
+            // each distinct type is inspected only once.
+            mlir::AttrTypeWalker walker;
+            walker.addWalk([&] (mlir_type type) {
+                if (auto name = referenced_decl_name(type))
+                    mark_live(*name);
+            });
+
+            for (auto op : roots)
+                scan(op, walker);
+
+            while (!worklist.empty()) {
+                auto decl = worklist.back();
+                worklist.pop_back();
+                scan(decl, walker);
+            }
+
+            for (auto op : candidates)
+                if (!live.contains(op))
+                    op->erase();
+
+            candidates.clear();
+            decls.clear();
+            enum_of_constant.clear();
+            live.clear();
+        }
+    };
+
+    std::unique_ptr< mlir::Pass > createPruneUnusedTypesPass()
+    {
+        return std::make_unique< PruneUnusedTypes >();
+    }
+} // namespace vast::hl
@@ -24,6 +24,20 @@ namespace vast::ll
         return mlir::SuccessorOperands( getOperandsMutable() );
     }
 
+    logical_result Switch::verify()
+    {
+        auto values = getCaseValues();
+        if (values.getNumElements() != static_cast< std::int64_t >(getCaseDests().size()))
+            return emitOpError("expects one case value per case destination");
+
+        auto type = mlir::cast< mlir::IntegerType >(getValue().getType());
+        auto element = mlir::dyn_cast< mlir::IntegerType >(values.getElementType());
+        if (!element || !element.isSignless() || element.getWidth() != type.getWidth())
+            return emitOpError("expects signless case values of the width of the value");
+
+        return mlir::success();
+    }
+
     // This is currently stolen from HighLevel/HighLevelOps.cpp.
     // Do we need a separate version?
 
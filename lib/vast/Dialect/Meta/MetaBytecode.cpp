@@ -0,0 +1,61 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Bytecode/BytecodeImplementation.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/Meta/MetaAttributes.hpp"
+#include "vast/Dialect/Meta/MetaDialect.hpp"
+
+#include "vast/Util/Common.hpp"
+
+namespace vast::meta
+{
+    namespace
+    {
+        // Codes of attributes in bytecode, new codes have to be appended to
+        // keep the existing bytecode readable.
+        enum class attr_code : std::uint64_t { identifier = 0 };
+
+    } // namespace
+
+    struct MetaBytecodeDialectInterface : mlir::BytecodeDialectInterface
+    {
+        using mlir::BytecodeDialectInterface::BytecodeDialectInterface;
+
+        mlir_attr readAttribute(mlir::DialectBytecodeReader &reader) const final {
+            std::uint64_t code, value;
+            if (mlir::failed(reader.readVarInt(code))) {
+                return {};
+            }
+
+            if (code != static_cast< std::uint64_t >(attr_code::identifier)) {
+                reader.emitError() << "unknown meta attribute code: " << code;
+                return {};
+            }
+
+            if (mlir::failed(reader.readVarInt(value))) {
+                return {};
+            }
+
+            return IdentifierAttr::get(getContext(), value);
+        }
+
+        logical_result writeAttribute(mlir_attr attr, mlir::DialectBytecodeWriter &writer) const final {
+            if (auto id = mlir::dyn_cast< IdentifierAttr >(attr)) {
+                writer.writeVarInt(static_cast< std::uint64_t >(attr_code::identifier));
+                writer.writeVarInt(id.getValue());
+                return mlir::success();
+            }
+
+            return mlir::failure();
+        }
+    };
+
+    void add_bytecode_interface(MetaDialect *dialect) {
+        dialect->addInterfaces< MetaBytecodeDialectInterface >();
+    }
+
+} // namespace vast::meta
@@ -15,6 +15,8 @@ namespace vast::meta
             #define GET_OP_LIST
             #include "vast/Dialect/Meta/Meta.cpp.inc"
         >();
+
+        add_bytecode_interface(this);
     }
 
     static constexpr std::string_view identifier_name = "meta_identifier";
@@ -3,7 +3,14 @@
 #include "vast/Frontend/Action.hpp"
 
 #include "vast/Util/Common.hpp"
+#include "vast/Frontend/Cache.hpp"
 #include "vast/Frontend/Consumer.hpp"
+#include "vast/Frontend/FunctionCache.hpp"
+#include "vast/Frontend/HeaderCache.hpp"
+
+VAST_RELAX_WARNINGS
+#include <clang/Lex/Preprocessor.h>
+VAST_UNRELAX_WARNINGS
 
 namespace clang {
     class CXXRecordDecl;
@@ -17,7 +24,7 @@ namespace vast::cc {
 
     namespace opt {
         bool emit_only_mlir(const vast_args &vargs) {
-            for (auto arg : { emit_mlir }) {
+            for (auto arg : { emit_mlir, emit_mlir_bytecode }) {
                 if (vargs.has_option(arg)) {
                     return true;
                 }
@@ -30,12 +37,12 @@ namespace vast::cc {
 
     } // namespace opt
 
-    static std::string get_output_stream_suffix(output_type act) {
+    static std::string get_output_stream_suffix(output_type act, const vast_args &vargs) {
         switch (act) {
             case output_type::emit_assembly:
                 return "s";
             case output_type::emit_mlir:
-                return "mlir";
+                return vargs.has_option(opt::emit_mlir_bytecode) ? "mlirbc" : "mlir";
             case output_type::emit_llvm:
                 return "ll";
             case output_type::emit_obj:
@@ -47,18 +54,24 @@ namespace vast::cc {
         VAST_UNREACHABLE("unsupported action type");
     }
 
-    static auto get_output_stream(compiler_instance &ci, string_ref in, output_type act)
-        -> output_stream_ptr
-    {
+    static bool is_binary_output(output_type act, const vast_args &vargs) {
+        return act == output_type::emit_mlir && vargs.has_option(opt::emit_mlir_bytecode);
+    }
+
+    static auto get_output_stream(
+        compiler_instance &ci, string_ref in, output_type act, const vast_args &vargs
+    ) -> output_stream_ptr {
         if (act == output_type::none) {
             return nullptr;
         }
 
-        return ci.createDefaultOutputFile(false, in, get_output_stream_suffix(act));
+        return ci.createDefaultOutputFile(
+            is_binary_output(act, vargs), in, get_output_stream_suffix(act, vargs)
+        );
     }
 
-    vast_action::vast_action(output_type act, const vast_args &vargs)
-        : action(act), vargs(vargs)
+    vast_action::vast_action(output_type act, const vast_args &vargs, mcontext_t *mctx)
+        : action(act), vargs(vargs), mctx(mctx)
     {}
 
     void vast_action::ExecuteAction() {
@@ -71,11 +84,26 @@ namespace vast::cc {
     {
         auto out = ci.takeOutputStream();
         if (!out) {
-            out = get_output_stream(ci, input, action);
+            out = get_output_stream(ci, input, action, vargs);
+        }
+
+        // The header and function caches keep no C++ declarations yet.
+        std::shared_ptr< header_cache > headers;
+        if (auto dir = vargs.get_option(opt::header_cache); dir && !ci.getLangOpts().CPlusPlus) {
+            headers = std::make_shared< header_cache >(
+                working_path(ci.getFileSystemOpts(), *dir), compilation_identity(ci));
+            ci.getPreprocessor().addPPCallbacks(headers->make_tracker(ci.getPreprocessor()));
+        }
+
+        std::shared_ptr< function_cache > functions;
+        if (auto dir = vargs.get_option(opt::function_cache); dir && !ci.getLangOpts().CPlusPlus) {
+            functions = std::make_shared< function_cache >(
+                working_path(ci.getFileSystemOpts(), *dir), function_cache::seed(ci, vargs));
         }
 
         auto result = std::make_unique< vast_consumer >(
-            action, options(ci), vargs, std::move(out)
+            action, options(ci), vargs, std::move(out), mctx,
+            std::move(headers), std::move(functions)
         );
 
         consumer = result.get();
@@ -103,29 +131,36 @@ namespace vast::cc {
     // emit assembly
     void emit_assembly_action::anchor() {}
 
-    emit_assembly_action::emit_assembly_action(const vast_args &vargs)
-        : vast_action(output_type::emit_assembly, vargs)
+    emit_assembly_action::emit_assembly_action(const vast_args &vargs, mcontext_t *mctx)
+        : vast_action(output_type::emit_assembly, vargs, mctx)
     {}
 
     // emit_llvm
     void emit_llvm_action::anchor() {}
 
-    emit_llvm_action::emit_llvm_action(const vast_args &vargs)
-        : vast_action(output_type::emit_llvm, vargs)
+    emit_llvm_action::emit_llvm_action(const vast_args &vargs, mcontext_t *mctx)
+        : vast_action(output_type::emit_llvm, vargs, mctx)
     {}
 
     // emit_mlir
     void emit_mlir_action::anchor() {}
 
-    emit_mlir_action::emit_mlir_action(const vast_args &vargs)
-        : vast_action(output_type::emit_mlir, vargs)
+    emit_mlir_action::emit_mlir_action(const vast_args &vargs, mcontext_t *mctx)
+        : vast_action(output_type::emit_mlir, vargs, mctx)
+    {}
+
+    // emit_stages
+    void emit_stages_action::anchor() {}
+
+    emit_stages_action::emit_stages_action(const vast_args &vargs, mcontext_t *mctx)
+        : vast_action(output_type::none, vargs, mctx)
     {}
 
     // emit_obj
     void emit_obj_action::anchor() {}
 
-    emit_obj_action::emit_obj_action(const vast_args &vargs)
-        : vast_action(output_type::emit_obj, vargs)
+    emit_obj_action::emit_obj_action(const vast_args &vargs, mcontext_t *mctx)
+        : vast_action(output_type::emit_obj, vargs, mctx)
     {}
 
 } // namespace vast::cc
@@ -0,0 +1,447 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Frontend/Cache.hpp"
+
+VAST_RELAX_WARNINGS
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Basic/SourceManager.h>
+#include <clang/Frontend/CompilerInvocation.h>
+#include <clang/Frontend/FrontendAction.h>
+#include <clang/Lex/Preprocessor.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include <mlir/Bytecode/BytecodeWriter.h>
+#include <mlir/IR/Diagnostics.h>
+#include <mlir/Parser/Parser.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Config/config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace vast::cc {
+
+    void key_hasher::add(string_ref str) {
+        add(static_cast< std::uint64_t >(str.size()));
+        hasher.update(str);
+    }
+
+    void key_hasher::add(std::uint64_t value) {
+        hasher.update(llvm::ArrayRef(
+            reinterpret_cast< const std::uint8_t * >(&value), sizeof(value)
+        ));
+    }
+
+    std::string key_hasher::final() {
+        return llvm::toHex(hasher.final(), /* LowerCase */ true);
+    }
+
+    std::string build_identity() {
+        key_hasher hasher;
+        hasher.add(vast::version);
+
+        auto exe = llvm::sys::fs::getMainExecutable(nullptr, nullptr);
+        llvm::sys::fs::file_status status;
+        if (!exe.empty() && !llvm::sys::fs::status(exe, status)) {
+            hasher.add(exe);
+            hasher.add(status.getSize());
+            hasher.add(static_cast< std::uint64_t >(
+                status.getLastModificationTime().time_since_epoch().count()
+            ));
+        }
+
+        return hasher.final();
+    }
+
+    std::string compilation_identity(compiler_instance &ci) {
+        key_hasher hasher;
+        hasher.add(build_identity());
+        // covers language, target and preprocessor options
+        hasher.add(ci.getInvocation().getModuleHash());
+        hasher.add(ci.getTargetOpts().Triple);
+        return hasher.final();
+    }
+
+    std::string cache_entry_path(string_ref dir, string_ref key, string_ref extension) {
+        llvm::SmallString< 256 > path(dir);
+        llvm::sys::path::append(path, key.take_front(2), key + extension);
+        return path.str().str();
+    }
+
+    owning_module_ref read_module_entry(string_ref path, mcontext_t &mctx) {
+        if (!llvm::sys::fs::exists(path)) {
+            return {};
+        }
+
+        // A stale or broken entry is just a miss.
+        mlir::ScopedDiagnosticHandler silence(&mctx, [] (mlir::Diagnostic &) {
+            return mlir::success();
+        });
+
+        return mlir::parseSourceFile< vast_module >(path, mlir::ParserConfig(&mctx));
+    }
+
+    bool write_module_entry(string_ref path, vast_module mod) {
+        auto parent = llvm::sys::path::parent_path(path);
+        if (llvm::sys::fs::create_directories(parent)) {
+            return false;
+        }
+
+        int fd = -1;
+        llvm::SmallString< 256 > tmp;
+        auto model = (llvm::sys::path::filename(path) + "-%%%%%%%%.tmp").str();
+        llvm::SmallString< 256 > pattern(parent);
+        llvm::sys::path::append(pattern, model);
+        if (llvm::sys::fs::createUniqueFile(pattern, fd, tmp)) {
+            return false;
+        }
+
+        {
+            llvm::raw_fd_ostream os(fd, /* shouldClose */ true);
+            mlir::BytecodeWriterConfig config("VAST");
+            if (mlir::failed(mlir::writeBytecodeToFile(mod, os, config)) || os.has_error()) {
+                os.clear_error();
+                llvm::sys::fs::remove(tmp);
+                return false;
+            }
+        }
+
+        // The last rename wins.
+        if (llvm::sys::fs::rename(tmp, path)) {
+            llvm::sys::fs::remove(tmp);
+            return false;
+        }
+
+        return true;
+    }
+
+    namespace {
+
+        // Hashes the token stream of the preprocessed translation unit
+        // together with token locations, which end up in the output.
+        struct hash_preprocessed_action : clang::PreprocessorFrontendAction {
+            explicit hash_preprocessed_action(key_hasher &hasher) : hasher(hasher) {}
+
+            void ExecuteAction() override {
+                auto &pp = getCompilerInstance().getPreprocessor();
+                auto &sm = pp.getSourceManager();
+
+                pp.EnterMainSourceFile();
+
+                string_ref current_file;
+                clang::Token tok;
+                for (pp.Lex(tok); tok.isNot(clang::tok::eof); pp.Lex(tok)) {
+                    auto loc = sm.getPresumedLoc(tok.getLocation());
+                    if (loc.isValid()) {
+                        if (current_file != loc.getFilename()) {
+                            current_file = loc.getFilename();
+                            hasher.add(current_file);
+                        }
+
+                        hasher.add(loc.getLine());
+                        hasher.add(loc.getColumn());
+                    }
+
+                    hasher.add(pp.getSpelling(tok));
+                }
+            }
+
+            key_hasher &hasher;
+        };
+
+        bool is_cache_option(string_ref arg) {
+            return arg.starts_with("-vast-cache-");
+        }
+
+        void add_compile_options(key_hasher &hasher, compiler_instance &ci, const vast_args &vargs) {
+            auto &inv = ci.getInvocation();
+
+            // covers language, target and preprocessor options
+            hasher.add(inv.getModuleHash());
+
+            const auto &target = ci.getTargetOpts();
+            hasher.add(target.Triple);
+            hasher.add(target.CPU);
+            for (const auto &feature : target.FeaturesAsWritten) {
+                hasher.add(feature);
+            }
+
+            // The module hash leaves out diagnostic options, which decide
+            // whether the compilation succeeds without diagnostics.
+            const auto &diag = ci.getDiagnosticOpts();
+            for (const auto &warning : diag.Warnings) {
+                hasher.add(warning);
+            }
+            for (const auto &remark : diag.Remarks) {
+                hasher.add(remark);
+            }
+            for (const auto &module : diag.SystemHeaderWarningsModules) {
+                hasher.add(module);
+            }
+#define DIAGOPT(Name, Bits, Default) hasher.add(static_cast< std::uint64_t >(diag.Name));
+#define ENUM_DIAGOPT(Name, Type, Bits, Default) hasher.add(static_cast< std::uint64_t >(diag.get##Name()));
+#include <clang/Basic/DiagnosticOptions.def>
+
+            const auto &cg = ci.getCodeGenOpts();
+            hasher.add(cg.OptimizationLevel);
+            hasher.add(cg.OptimizeSize);
+            hasher.add(static_cast< std::uint64_t >(cg.getDebugInfo()));
+            hasher.add(static_cast< std::uint64_t >(cg.RelocationModel));
+
+            hasher.add(static_cast< std::uint64_t >(ci.getFrontendOpts().ProgramAction));
+
+            for (auto arg : vargs.args) {
+                if (!is_cache_option(arg)) {
+                    hasher.add(string_ref(arg));
+                }
+            }
+        }
+
+        std::string absolute_output(compiler_instance &ci, string_ref output) {
+            llvm::SmallString< 256 > path(working_path(ci.getFileSystemOpts(), output));
+            llvm::sys::fs::make_absolute(path);
+            return path.str().str();
+        }
+
+        // Copies `from` to a temporary file next to `to` and renames it over
+        // `to`, so that readers of `to` never see a partial file.
+        bool copy_atomically(string_ref from, string_ref to) {
+            llvm::SmallString< 256 > tmp;
+            auto model = (llvm::sys::path::filename(to) + "-%%%%%%%%.tmp").str();
+            llvm::SmallString< 256 > pattern(llvm::sys::path::parent_path(to));
+            llvm::sys::path::append(pattern, model);
+
+            int fd = -1;
+            if (llvm::sys::fs::createUniqueFile(pattern, fd, tmp)) {
+                return false;
+            }
+            llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+            if (llvm::sys::fs::copy_file(from, tmp) || llvm::sys::fs::rename(tmp, to)) {
+                llvm::sys::fs::remove(tmp);
+                return false;
+            }
+
+            return true;
+        }
+
+        // File keeping the approximate size of the cache, so that stores do
+        // not have to scan the whole cache.
+        constexpr string_ref size_index_name = "size";
+
+        std::optional< std::uint64_t > read_size_index(string_ref path) {
+            auto buffer = llvm::MemoryBuffer::getFile(path);
+            if (!buffer) {
+                return std::nullopt;
+            }
+
+            std::uint64_t size = 0;
+            if ((*buffer)->getBuffer().trim().getAsInteger(10, size)) {
+                return std::nullopt;
+            }
+
+            return size;
+        }
+
+        void write_size_index(string_ref path, std::uint64_t size) {
+            auto error = llvm::writeToOutput(path, [&] (llvm::raw_ostream &os) {
+                os << size << '\n';
+                return llvm::Error::success();
+            });
+            llvm::consumeError(std::move(error));
+        }
+
+        void touch(string_ref path) {
+            int fd = -1;
+            if (llvm::sys::fs::openFileForWrite(path, fd, llvm::sys::fs::CD_OpenExisting, llvm::sys::fs::OF_Append)) {
+                return;
+            }
+
+            auto now = std::chrono::system_clock::now();
+            llvm::sys::fs::setLastAccessAndModificationTime(fd, now);
+            llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+        }
+
+    } // namespace
+
+    std::optional< result_cache > result_cache::get(compiler_instance &ci, const vast_args &vargs) {
+        auto dir = vargs.get_option(opt::cache_dir);
+        if (!dir || dir->empty()) {
+            return std::nullopt;
+        }
+
+        const auto &front = ci.getFrontendOpts();
+        if (front.Inputs.size() != 1 || !front.Inputs.front().isFile()) {
+            return std::nullopt;
+        }
+
+        // Only outputs written to a file are cached, and diagnostics checking
+        // has to see the real compilation.
+        if (front.OutputFile.empty() || front.OutputFile == "-") {
+            return std::nullopt;
+        }
+
+        // Precompiled headers and modules record modification times of their
+        // inputs, a restored one would be rejected.
+        using namespace clang::frontend;
+        switch (front.ProgramAction) {
+            case GeneratePCH:
+            case GenerateModule:
+            case GenerateModuleInterface:
+                return std::nullopt;
+            default:
+                break;
+        }
+
+        // Outputs of -vast-emit are not tracked by the cache.
+        if (vargs.has_option(opt::vast_verify_diags) || vargs.has_option(opt::emit)) {
+            return std::nullopt;
+        }
+
+        std::uint64_t max_size = default_size;
+        if (auto size = vargs.get_option(opt::cache_size)) {
+            if (size->getAsInteger(10, max_size)) {
+                VAST_UNREACHABLE("Invalid cache size: {0}", *size);
+            }
+        }
+
+        key_hasher hasher;
+        hasher.add(build_identity());
+        add_compile_options(hasher, ci, vargs);
+        hasher.add(front.Inputs.front().getFile());
+
+        // Preprocess in a separate instance to leave the diagnostics and
+        // state of the real compilation untouched.
+        compiler_instance pp;
+        pp.setInvocation(std::make_shared< clang::CompilerInvocation >(ci.getInvocation()));
+        pp.createDiagnostics(new clang::IgnoringDiagConsumer(), /* ShouldOwnClient */ true);
+
+        hash_preprocessed_action action(hasher);
+        if (!pp.ExecuteAction(action) || pp.getDiagnostics().hasErrorOccurred()) {
+            return std::nullopt;
+        }
+
+        return result_cache{
+            .dir      = working_path(ci.getFileSystemOpts(), *dir),
+            .key      = hasher.final(),
+            .output   = absolute_output(ci, front.OutputFile),
+            .max_size = max_size << 20
+        };
+    }
+
+    std::string result_cache::entry_path() const {
+        return cache_entry_path(dir, key);
+    }
+
+    bool result_cache::restore() const {
+        auto entry = entry_path();
+        if (!llvm::sys::fs::exists(entry)) {
+            return false;
+        }
+
+        // The entry may be evicted concurrently, that is just a miss.
+        if (!copy_atomically(entry, output)) {
+            return false;
+        }
+
+        touch(entry);
+        return true;
+    }
+
+    void result_cache::store(compiler_instance &ci) const {
+        auto &diags = ci.getDiagnostics();
+        if (diags.hasErrorOccurred() || diags.getNumWarnings() != 0) {
+            return;
+        }
+
+        auto entry = entry_path();
+        if (llvm::sys::fs::create_directories(llvm::sys::path::parent_path(entry))) {
+            return;
+        }
+
+        if (!copy_atomically(output, entry)) {
+            return;
+        }
+
+        std::uint64_t size = 0;
+        if (llvm::sys::fs::file_size(entry, size)) {
+            return;
+        }
+
+        // Concurrent stores may lose updates of the index, which only delays
+        // the eviction. The scan recomputes the real size.
+        auto index = size_index_path();
+        auto total = read_size_index(index);
+        if (!total || *total + size > max_size) {
+            evict();
+        } else {
+            write_size_index(index, *total + size);
+        }
+    }
+
+    std::string result_cache::size_index_path() const {
+        llvm::SmallString< 256 > path(dir);
+        llvm::sys::path::append(path, size_index_name);
+        return path.str().str();
+    }
+
+    void result_cache::evict() const {
+        struct entry_info {
+            std::string path;
+            std::uint64_t size;
+            llvm::sys::TimePoint<> mtime;
+        };
+
+        std::vector< entry_info > entries;
+        std::uint64_t total = 0;
+
+        auto index = size_index_path();
+
+        std::error_code ec;
+        for (llvm::sys::fs::recursive_directory_iterator it(dir, ec), end; it != end && !ec; it.increment(ec)) {
+            llvm::sys::fs::file_status status;
+            if (llvm::sys::fs::status(it->path(), status)) {
+                continue;
+            }
+
+            if (status.type() != llvm::sys::fs::file_type::regular_file || it->path() == index) {
+                continue;
+            }
+
+            entries.push_back({ it->path(), status.getSize(), status.getLastModificationTime() });
+            total += status.getSize();
+        }
+
+        if (total <= max_size) {
+            write_size_index(index, total);
+            return;
+        }
+
+        std::sort(entries.begin(), entries.end(), [] (const auto &a, const auto &b) {
+            return a.mtime < b.mtime;
+        });
+
+        // Evict below the limit to not scan the cache on every store.
+        auto target = max_size / 10 * 9;
+        for (const auto &entry : entries) {
+            if (total <= target) {
+                break;
+            }
+
+            // Removal races with other writers are harmless, the entry is
+            // either gone or replaced by an identical one.
+            if (!llvm::sys::fs::remove(entry.path)) {
+                total -= entry.size;
+            }
+        }
+
+        write_size_index(index, total);
+    }
+
+} // namespace vast::cc
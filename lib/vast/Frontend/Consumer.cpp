@@ -3,7 +3,13 @@
 #include "vast/Frontend/Consumer.hpp"
 
 VAST_RELAX_WARNINGS
+#include <clang/Basic/DiagnosticFrontend.h>
 #include <llvm/Support/Signals.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <mlir/Bytecode/BytecodeWriter.h>
+#include <mlir/Pass/PassManager.h>
+#include <mlir/Transforms/Passes.h>
 
 #include <mlir/Target/LLVMIR/Dialect/All.h>
 #include <mlir/Target/LLVMIR/LLVMTranslationInterface.h>
@@ -16,6 +22,9 @@ VAST_UNRELAX_WARNINGS
 #include "vast/CodeGen/CodeGenContext.hpp"
 #include "vast/CodeGen/CodeGenDriver.hpp"
 
+#include "vast/Frontend/FunctionCache.hpp"
+#include "vast/Frontend/HeaderCache.hpp"
+
 #include "vast/Util/Common.hpp"
 
 #include "vast/Target/LLVMIR/Convert.hpp"
@@ -43,13 +52,30 @@ namespace vast::cc {
     source_language get_source_language(const cc::language_options &opts);
 
     void vast_consumer::Initialize(acontext_t &actx) {
-        VAST_CHECK(!mctx, "initialized multiple times");
-        mctx = std::make_unique< mcontext_t >();
+        VAST_CHECK(!cgctx, "initialized multiple times");
+        if (!mctx) {
+            owned_mctx = std::make_unique< mcontext_t >();
+            mctx = owned_mctx.get();
+        }
+
         cgctx = std::make_unique< cg::codegen_context >(
             *mctx, actx, get_source_language(opts.lang)
         );
 
+        if (auto threshold = vargs.get_option(opt::strlit_resource_threshold)) {
+            std::size_t value = 0;
+            if (threshold->getAsInteger(10, value)) {
+                VAST_UNREACHABLE("Invalid string literal resource threshold: {0}", *threshold);
+            }
+            cgctx->strlit_resource_threshold = value;
+        }
+
         codegen = std::make_unique< cg::codegen_driver >(*cgctx, opts);
+        codegen->set_function_cache(functions.get());
+
+        if (vargs.has_option(opt::verify_functions) && !vargs.has_option(opt::disable_vast_verifier)) {
+            codegen->enable_function_verifier();
+        }
     }
 
     bool vast_consumer::HandleTopLevelDecl(clang::DeclGroupRef decls) {
@@ -62,19 +88,42 @@ namespace vast::cc {
             return true;
         }
 
-        return codegen->handle_top_level_decl(decls), true;
+        // Declarations of precompiled headers precede the parsed ones.
+        codegen->handle_external_decls();
+
+        if (!headers) {
+            return codegen->handle_top_level_decl(decls), true;
+        }
+
+        cg::defer_handle_of_top_level_decl defer(*codegen);
+        for (auto decl : decls) {
+            headers->handle(decl, *cgctx, [&] { codegen->handle_top_level_decl(decl); });
+        }
+
+        return true;
     }
 
-    void vast_consumer::HandleCXXStaticMemberVarInstantiation(clang::VarDecl * /* decl */) {
-        VAST_UNIMPLEMENTED;
+    void vast_consumer::HandleCXXStaticMemberVarInstantiation(clang::VarDecl *decl) {
+        if (opts.diags.hasErrorOccurred()) {
+            return;
+        }
+
+        codegen->handle_cxx_static_member_var_instantiation(decl);
     }
 
-    void vast_consumer::HandleInlineFunctionDefinition(clang::FunctionDecl * /* decl */) {
-        VAST_UNIMPLEMENTED;
+    void vast_consumer::HandleInlineFunctionDefinition(clang::FunctionDecl *decl) {
+        if (opts.diags.hasErrorOccurred()) {
+            return;
+        }
+
+        codegen->handle_inline_function_definition(decl);
     }
 
-    void vast_consumer::HandleInterestingDecl(clang::DeclGroupRef /* decl */) {
-        VAST_UNIMPLEMENTED;
+    void vast_consumer::HandleInterestingDecl(clang::DeclGroupRef /* decls */) {
+        // Interesting declarations are deserialized from precompiled headers
+        // and modules, possibly while generating code of another declaration.
+        // They are emitted together with the rest of the deserialized
+        // top-level declarations by `handle_external_decls` instead.
     }
 
     void vast_consumer::HandleTranslationUnit(acontext_t &actx) {
@@ -89,26 +138,38 @@ namespace vast::cc {
             }
         }
 
+        if (headers) {
+            headers->store(*cgctx);
+        }
+
+        if (functions) {
+            functions->store(*cgctx);
+        }
+
         auto mod  = std::move(cgctx->mod);
 
-        compile_via_vast(mod.get(), mctx.get());
+        compile_via_vast(mod.get(), mctx);
+
+        if (auto stages = vargs.get_option(opt::emit)) {
+            return emit_stages(parse_emit_requests(*stages), std::move(mod), mctx);
+        }
 
         switch (action) {
             case output_type::emit_assembly:
                 return emit_backend_output(
-                    backend::Backend_EmitAssembly, std::move(mod), mctx.get()
+                    backend::Backend_EmitAssembly, std::move(mod), mctx
                 );
             case output_type::emit_mlir: {
                 auto trg = parse_target_dialect(vargs.get_options_list(opt::emit_mlir));
-                return emit_mlir_output(trg, std::move(mod), mctx.get());
+                return emit_mlir_output(trg, std::move(mod), mctx);
             }
             case output_type::emit_llvm:
                 return emit_backend_output(
-                    backend::Backend_EmitLL, std::move(mod), mctx.get()
+                    backend::Backend_EmitLL, std::move(mod), mctx
                 );
             case output_type::emit_obj:
                 return emit_backend_output(
-                    backend::Backend_EmitObj, std::move(mod), mctx.get()
+                    backend::Backend_EmitObj, std::move(mod), mctx
                 );
             case output_type::none:
                 break;
@@ -151,6 +212,7 @@ namespace vast::cc {
     // }
 
     void vast_consumer::CompleteTentativeDefinition(clang::VarDecl *decl) {
+        codegen->handle_external_decls();
         codegen->handle_top_level_decl(decl);
     }
 
@@ -173,13 +235,114 @@ namespace vast::cc {
         llvmir::lower_hl_module(mlir_module.get(), pipeline);
 
         auto mod = llvmir::translate(mlir_module.get(), llvm_context);
-        auto dl  = cgctx->actx.getTargetInfo().getDataLayoutString();
+        run_backend(backend_action, mod.get(), std::move(output_stream));
+    }
+
+    void vast_consumer::run_backend(
+        backend backend_action, llvm::Module *mod, output_stream_ptr os
+    ) {
+        auto dl = cgctx->actx.getTargetInfo().getDataLayoutString();
         clang::EmitBackendOutput(
-            opts.diags, opts.headers, opts.codegen, opts.target, opts.lang, dl, mod.get(),
-            backend_action, &opts.vfs, std::move(output_stream)
+            opts.diags, opts.headers, opts.codegen, opts.target, opts.lang, dl, mod,
+            backend_action, &opts.vfs, std::move(os)
         );
     }
 
+    output_stream_ptr vast_consumer::open_output(string_ref path, bool binary) {
+        std::error_code ec;
+        auto flags = binary ? llvm::sys::fs::OF_None : llvm::sys::fs::OF_TextWithCRLF;
+        auto os = std::make_unique< llvm::raw_fd_ostream >(
+            working_path(opts.files, path), ec, flags
+        );
+        if (ec) {
+            opts.diags.Report(clang::diag::err_fe_unable_to_open_output) << path << ec.message();
+            return nullptr;
+        }
+
+        return os;
+    }
+
+    // Writes every requested stage from a single codegen. The module is
+    // lowered once, each stage is written as soon as the module reaches it.
+    void vast_consumer::emit_stages(
+        const emit_requests &requests, owning_module_ref mod, mcontext_t *mctx
+    ) {
+        auto last_stage = [&] {
+            emit_stage last = emit_stage::high_level;
+            for (const auto &req : requests) {
+                last = std::max(last, req.stage);
+            }
+            return last;
+        } ();
+
+        auto write_mlir = [&] (emit_stage stage) {
+            for (const auto &req : requests) {
+                if (req.stage == stage) {
+                    if (auto os = open_output(req.path, /* binary */ false)) {
+                        print_mlir(mod.get(), *os);
+                    }
+                }
+            }
+        };
+
+        write_mlir(emit_stage::high_level);
+        if (last_stage == emit_stage::high_level) {
+            return;
+        }
+
+        auto &src_mgr = cgctx->actx.getSourceManager();
+        llvm::SourceMgr mlir_src_mgr;
+        mlir_src_mgr.AddNewSourceBuffer(
+            llvm::MemoryBuffer::getMemBuffer(src_mgr.getBufferOrFake(src_mgr.getMainFileID())),
+            llvm::SMLoc()
+        );
+        mlir::SourceMgrDiagnosticHandler src_mgr_handler(mlir_src_mgr, mctx);
+
+        llvmir::register_vast_to_llvm_ir(*mctx);
+        auto pipeline = parse_pipeline(vargs.get_options_list(opt::opt_pipeline));
+        llvmir::lower_hl_module(mod.get(), pipeline);
+
+        write_mlir(emit_stage::llvm_dialect);
+        if (last_stage == emit_stage::llvm_dialect) {
+            return;
+        }
+
+        llvm::LLVMContext llvm_context;
+        auto llvm_module = llvmir::translate(mod.get(), llvm_context);
+
+        auto backend_action = [] (emit_stage stage) {
+            switch (stage) {
+                case emit_stage::llvm_ir:  return backend::Backend_EmitLL;
+                case emit_stage::assembly: return backend::Backend_EmitAssembly;
+                case emit_stage::object:   return backend::Backend_EmitObj;
+                default: VAST_UNREACHABLE("not a backend stage");
+            }
+        };
+
+        std::vector< const emit_request * > backend_requests;
+        for (const auto &req : requests) {
+            if (req.stage >= emit_stage::llvm_ir) {
+                backend_requests.push_back(&req);
+            }
+        }
+
+        // The backend optimizes the module in place, all but the last output
+        // are produced from a copy of the translated module.
+        for (const auto *req : backend_requests) {
+            auto os = open_output(req->path, req->stage == emit_stage::object);
+            if (!os) {
+                continue;
+            }
+
+            if (req == backend_requests.back()) {
+                run_backend(backend_action(req->stage), llvm_module.get(), std::move(os));
+            } else {
+                auto copy = llvm::CloneModule(*llvm_module);
+                run_backend(backend_action(req->stage), copy.get(), std::move(os));
+            }
+        }
+    }
+
     void vast_consumer::emit_mlir_output(
         target_dialect target, owning_module_ref mod, mcontext_t *mctx
     ) {
@@ -235,11 +398,49 @@ namespace vast::cc {
         //     generator->build_default_methods();
         // }
 
+        if (vargs.has_option(opt::emit_mlir_bytecode)) {
+            return emit_mlir_bytecode(mod.get(), mctx);
+        }
+
+        print_mlir(mod.get(), *output_stream);
+    }
+
+    void vast_consumer::print_mlir(vast_module mod, llvm::raw_ostream &os) {
         // FIXME: we cannot roundtrip prettyForm=true right now.
         mlir::OpPrintingFlags flags;
         flags.enableDebugInfo(vargs.has_option(opt::emit_locs), /* prettyForm */ true);
 
-        mod->print(*output_stream, flags);
+        // Large literal blobs are not meant to be inspected textually.
+        if (auto threshold = cgctx->strlit_resource_threshold) {
+            flags.elideLargeResourceString(std::int64_t(*threshold));
+        }
+
+        mod->print(os, flags);
+    }
+
+    void vast_consumer::emit_mlir_bytecode(vast_module mod, mcontext_t *mctx) {
+        // Bytecode always carries locations, drop them unless requested, so
+        // that the output matches the textual one.
+        if (!vargs.has_option(opt::emit_locs)) {
+            mlir::PassManager pm(mctx);
+            pm.addPass(mlir::createStripDebugInfoPass());
+            if (mlir::failed(pm.run(mod))) {
+                VAST_UNREACHABLE("Failed to strip locations from the module");
+            }
+        }
+
+        mlir::BytecodeWriterConfig config("VAST");
+        if (auto version = vargs.get_option(opt::emit_mlir_bytecode)) {
+            std::int64_t value = 0;
+            if (version->getAsInteger(10, value)) {
+                VAST_UNREACHABLE("Invalid bytecode version: {0}", *version);
+            }
+            config.setDesiredBytecodeVersion(value);
+        }
+
+        if (mlir::failed(mlir::writeBytecodeToFile(mod, *output_stream, config))) {
+            VAST_UNREACHABLE("Failed to write bytecode, unsupported version?");
+        }
     }
 
     void vast_consumer::compile_via_vast(vast_module mod, mcontext_t *mctx) {
@@ -301,6 +502,44 @@ namespace vast::cc {
         VAST_UNREACHABLE("Unknown option of pipeline to use: {0}", trg);
     }
 
+    emit_stage parse_emit_stage(string_ref from) {
+        auto stage = from.lower();
+        if (stage == "hl" || stage == "high_level") {
+            return emit_stage::high_level;
+        }
+        if (stage == "llvm-mlir") {
+            return emit_stage::llvm_dialect;
+        }
+        if (stage == "llvm") {
+            return emit_stage::llvm_ir;
+        }
+        if (stage == "asm") {
+            return emit_stage::assembly;
+        }
+        if (stage == "obj") {
+            return emit_stage::object;
+        }
+        VAST_UNREACHABLE("Unknown stage to emit: {0}", stage);
+    }
+
+    emit_requests parse_emit_requests(string_ref from) {
+        emit_requests requests;
+
+        auto tail = from;
+        while (!tail.empty()) {
+            auto [request, rest] = tail.split(',');
+            auto [stage, path] = request.split(':');
+            if (path.empty()) {
+                VAST_UNREACHABLE("Missing output path of emitted stage: {0}", request);
+            }
+
+            requests.push_back({ parse_emit_stage(stage), path });
+            tail = rest;
+        }
+
+        return requests;
+    }
+
     target_dialect parse_target_dialect(string_ref from) {
         auto trg = from.lower();
         if (trg == "hl" || trg == "high_level") {
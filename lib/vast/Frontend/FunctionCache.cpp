@@ -0,0 +1,348 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Frontend/FunctionCache.hpp"
+
+VAST_RELAX_WARNINGS
+#include <clang/AST/ODRHash.h>
+#include <clang/AST/RecursiveASTVisitor.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/ADT/FoldingSet.h>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/Support/Allocator.h>
+#include <mlir/IR/IRMapping.h>
+#include <mlir/IR/SymbolTable.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/Meta/MetaAttributes.hpp"
+#include "vast/Frontend/Cache.hpp"
+
+#include <optional>
+
+namespace vast::cc {
+
+    namespace {
+
+        //
+        // Hashes what the generated body depends on beyond the ODR hash, which
+        // keeps names of referenced declarations only in its 32-bit digest.
+        // Collects the declarations the body refers to.
+        //
+        struct fingerprint_visitor : clang::RecursiveASTVisitor< fingerprint_visitor > {
+            explicit fingerprint_visitor(key_hasher &hasher) : hasher(hasher) {}
+
+            void add(clang::QualType type) {
+                hasher.add(type.getAsString());
+                hasher.add(type.getCanonicalType().getAsString());
+            }
+
+            bool VisitValueDecl(clang::ValueDecl *decl) {
+                hasher.add(decl->getNameAsString());
+                add(decl->getType());
+                return true;
+            }
+
+            bool VisitExpr(clang::Expr *expr) {
+                add(expr->getType());
+                return true;
+            }
+
+            bool VisitDeclRefExpr(clang::DeclRefExpr *expr) {
+                auto decl = expr->getDecl()->getUnderlyingDecl();
+                hasher.add(decl->getDeclKindName());
+                hasher.add(decl->getNameAsString());
+
+                if (auto fn = clang::dyn_cast< clang::FunctionDecl >(decl)) {
+                    functions.push_back(fn);
+                } else if (auto var = clang::dyn_cast< clang::VarDecl >(decl)) {
+                    if (var->hasGlobalStorage()) {
+                        globals.push_back(var);
+                    }
+                } else if (auto con = clang::dyn_cast< clang::EnumConstantDecl >(decl)) {
+                    hasher.add(llvm::toString(con->getInitVal(), 10));
+                    constants.push_back(con);
+                }
+
+                return true;
+            }
+
+            bool VisitMemberExpr(clang::MemberExpr *expr) {
+                hasher.add(expr->getMemberDecl()->getNameAsString());
+                hasher.add(expr->isArrow());
+                return true;
+            }
+
+            bool VisitUnaryExprOrTypeTraitExpr(clang::UnaryExprOrTypeTraitExpr *expr) {
+                add(expr->getTypeOfArgument());
+                return true;
+            }
+
+            key_hasher &hasher;
+
+            std::vector< const clang::FunctionDecl * > functions;
+            std::vector< const clang::VarDecl * > globals;
+            std::vector< const clang::EnumConstantDecl * > constants;
+        };
+
+        struct fingerprint {
+            std::string key;
+
+            std::vector< const clang::FunctionDecl * > functions;
+            std::vector< const clang::VarDecl * > globals;
+            std::vector< const clang::EnumConstantDecl * > constants;
+        };
+
+        std::optional< fingerprint > make_fingerprint(
+            const clang::FunctionDecl *decl, string_ref seed
+        ) {
+            auto body = decl->getBody();
+            if (!body) {
+                return std::nullopt;
+            }
+
+            key_hasher hasher;
+            hasher.add(seed);
+
+            // The profile of the body keeps its structure and literals, the ODR
+            // hash adds the signature and the names used by the body.
+            clang::ODRHash odr;
+            llvm::FoldingSetNodeID profile;
+            body->ProcessODRHash(profile, odr);
+            odr.AddFunctionDecl(decl, /* SkipBody */ true);
+            hasher.add(odr.CalculateHash());
+
+            llvm::BumpPtrAllocator allocator;
+            auto data = profile.Intern(allocator);
+            hasher.add(string_ref(
+                reinterpret_cast< const char * >(data.getData()),
+                data.getSize() * sizeof(unsigned)
+            ));
+
+            fingerprint_visitor visitor(hasher);
+            visitor.TraverseDecl(const_cast< clang::FunctionDecl * >(decl));
+
+            return fingerprint{
+                .key       = hasher.final(),
+                .functions = std::move(visitor.functions),
+                .globals   = std::move(visitor.globals),
+                .constants = std::move(visitor.constants)
+            };
+        }
+
+        // Number of location identifiers of the stored body.
+        constexpr string_ref location_ids_attr = "vast.location_ids";
+
+        std::optional< meta::identifier_t > location_id(loc_t loc) {
+            if (auto fused = mlir::dyn_cast< mlir::FusedLoc >(loc)) {
+                if (auto id = mlir::dyn_cast_or_null< meta::IdentifierAttr >(fused.getMetadata())) {
+                    return id.getValue();
+                }
+            }
+            return std::nullopt;
+        }
+
+        using map_id = llvm::function_ref<
+            std::optional< meta::identifier_t >(meta::identifier_t)
+        >;
+
+        // Maps identifiers of locations in the body of `fn`, fails if `map`
+        // rejects some of them. Other locations are kept as they are.
+        bool map_location_ids(hl::FuncOp fn, map_id map) {
+            auto remap = [&] (loc_t loc) -> std::optional< loc_t > {
+                auto id = location_id(loc);
+                if (!id) {
+                    return loc;
+                }
+
+                auto mapped = map(*id);
+                if (!mapped) {
+                    return std::nullopt;
+                }
+
+                auto mctx = loc.getContext();
+                auto fused = mlir::cast< mlir::FusedLoc >(loc);
+                return mlir::FusedLoc::get(
+                    fused.getLocations(), meta::IdentifierAttr::get(mctx, *mapped), mctx
+                );
+            };
+
+            auto result = fn->walk([&] (mlir::Block *block) {
+                for (auto arg : block->getArguments()) {
+                    auto loc = remap(arg.getLoc());
+                    if (!loc) {
+                        return mlir::WalkResult::interrupt();
+                    }
+                    arg.setLoc(*loc);
+                }
+
+                for (auto &op : *block) {
+                    auto loc = remap(op.getLoc());
+                    if (!loc) {
+                        return mlir::WalkResult::interrupt();
+                    }
+                    op.setLoc(*loc);
+                }
+
+                return mlir::WalkResult::advance();
+            });
+
+            return !result.wasInterrupted();
+        }
+
+        hl::FuncOp cached_function(vast_module entry) {
+            for (auto fn : entry.getOps< hl::FuncOp >()) {
+                return fn;
+            }
+            return {};
+        }
+
+        // Symbols the body refers to have to be declared in the module.
+        bool symbols_declared(hl::FuncOp fn, cg::codegen_context &cgctx) {
+            auto uses = mlir::SymbolTable::getSymbolUses(&fn.getBody());
+            if (!uses) {
+                return false;
+            }
+
+            for (const auto &use : *uses) {
+                auto name = use.getSymbolRef().getRootReference().getValue();
+                if (!cgctx.lookup_function(cg::mangled_name_ref{ name }, false)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    } // namespace
+
+    function_cache::function_cache(string_ref dir, std::string seed)
+        : dir(dir.str()), seed_hash(std::move(seed))
+    {}
+
+    std::string function_cache::seed(compiler_instance &ci, const vast_args &vargs) {
+        key_hasher hasher;
+        hasher.add(compilation_identity(ci));
+        // decides how string literals of bodies are emitted
+        hasher.add(vargs.get_option(opt::strlit_resource_threshold).value_or(""));
+        return hasher.final();
+    }
+
+    bool function_cache::restore(
+        hl::FuncOp fn, const clang::FunctionDecl *decl,
+        cg::codegen_context &cgctx, declare_function declare, reserve_ids reserve
+    ) {
+        auto print = make_fingerprint(decl, seed_hash);
+        if (!print) {
+            return false;
+        }
+
+        // Callees are declared ahead of the body also when it is generated,
+        // so that their locations do not take identifiers of the body.
+        // Builtins are not called through declared functions.
+        for (auto callee : print->functions) {
+            if (!callee->getBuiltinID()) {
+                declare(callee);
+            }
+        }
+
+        auto miss = [&] { missing[decl] = print->key; return false; };
+
+        auto entry = read_module_entry(cache_entry_path(dir, print->key, ".mlirbc"), cgctx.mctx);
+        if (!entry) {
+            return miss();
+        }
+
+        auto cached = cached_function(entry.get());
+        if (!cached || cached.isDeclaration() || cached.getFunctionType() != fn.getFunctionType()) {
+            return miss();
+        }
+
+        for (auto var : print->globals) {
+            if (!cgctx.vars.lookup(var)) {
+                return miss();
+            }
+        }
+
+        for (auto con : print->constants) {
+            if (!cgctx.enumconsts.lookup(con)) {
+                return miss();
+            }
+        }
+
+        if (!symbols_declared(cached, cgctx)) {
+            return miss();
+        }
+
+        auto count = entry.get()->getAttrOfType< mlir::IntegerAttr >(location_ids_attr);
+        if (!count) {
+            return miss();
+        }
+
+        auto ids = count.getValue().getZExtValue();
+        auto in_range = [&] (meta::identifier_t id) -> std::optional< meta::identifier_t > {
+            if (id < ids) {
+                return id;
+            }
+            return std::nullopt;
+        };
+
+        if (!map_location_ids(cached, in_range)) {
+            return miss();
+        }
+
+        auto first = reserve(ids);
+        map_location_ids(cached, [&] (meta::identifier_t id) -> std::optional< meta::identifier_t > {
+            return first + id;
+        });
+
+        mlir::IRMapping mapping;
+        cached.getBody().cloneInto(&fn.getBody(), mapping);
+        return true;
+    }
+
+    void function_cache::record(
+        hl::FuncOp fn, const clang::FunctionDecl *decl,
+        meta::identifier_t first, meta::identifier_t count
+    ) {
+        if (auto it = missing.find(decl); it != missing.end()) {
+            generated.push_back({ std::move(it->second), fn, first, count });
+            missing.erase(it);
+        }
+    }
+
+    void function_cache::store(cg::codegen_context &cgctx) {
+        // Recorded functions may have been replaced since.
+        llvm::DenseSet< operation > live;
+        for (auto &op : cgctx.mod->getBody()->getOperations()) {
+            live.insert(&op);
+        }
+
+        for (const auto &body : generated) {
+            auto fn = body.fn;
+            if (!live.contains(fn.getOperation()) || fn.isDeclaration()) {
+                continue;
+            }
+
+            mlir::OpBuilder bld(&cgctx.mctx);
+            owning_module_ref entry(vast_module::create(bld.getUnknownLoc()));
+            bld.setInsertionPointToEnd(entry->getBody());
+            auto stored = mlir::cast< hl::FuncOp >(bld.clone(*fn));
+
+            // Identifiers are stored relative to the body, a body with
+            // locations from outside of its range cannot be restored.
+            auto relative = [&] (meta::identifier_t id) -> std::optional< meta::identifier_t > {
+                if (id >= body.first && id - body.first < body.count) {
+                    return id - body.first;
+                }
+                return std::nullopt;
+            };
+
+            if (!map_location_ids(stored, relative)) {
+                continue;
+            }
+
+            entry.get()->setAttr(location_ids_attr, bld.getI64IntegerAttr(std::int64_t(body.count)));
+            write_module_entry(cache_entry_path(dir, body.key, ".mlirbc"), entry.get());
+        }
+    }
+
+} // namespace vast::cc
@@ -0,0 +1,530 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Frontend/HeaderCache.hpp"
+
+VAST_RELAX_WARNINGS
+#include <clang/AST/RecursiveASTVisitor.h>
+#include <clang/Lex/MacroInfo.h>
+#include <clang/Lex/Preprocessor.h>
+#include <llvm/ADT/StringExtras.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/Core/CoreAttributes.hpp"
+#include "vast/Frontend/Cache.hpp"
+
+namespace vast::cc {
+
+    namespace {
+
+        // Marks operations generated for a header with its key until they are
+        // stored, operations replaced in the meantime are left unmarked.
+        constexpr string_ref header_key_attr = "vast.header_key";
+
+        std::optional< string_ref > symbol_name(operation op) {
+            if (auto fn = mlir::dyn_cast< hl::FuncOp >(op)) {
+                return fn.getSymName();
+            }
+
+            if (auto name = op->getAttrOfType< mlir::StringAttr >("name")) {
+                return name.getValue();
+            }
+
+            return std::nullopt;
+        }
+
+        std::string op_key(string_ref mnemonic, string_ref name) {
+            return (mnemonic + ":" + name).str();
+        }
+
+        // Declarations that depend only on the header they come from.
+        bool is_cacheable_op(operation op) {
+            if (auto fn = mlir::dyn_cast< hl::FuncOp >(op)) {
+                return fn.isDeclaration();
+            }
+
+            return mlir::isa<
+                hl::TypeDefOp, hl::TypeDeclOp, hl::StructDeclOp, hl::UnionDeclOp, hl::EnumDeclOp
+            >(op);
+        }
+
+        bool is_anonymous(string_ref name) { return name.starts_with("anonymous["); }
+
+        // Mirrors the tag predeclaration of the typedef codegen, reusable only
+        // if the walked tags are already emitted.
+        bool tags_emitted(clang::QualType type, cg::codegen_context &cgctx) {
+            if (auto tag = clang::dyn_cast< clang::TagType >(type)) {
+                auto decl = tag->getDecl();
+                if (auto enum_decl = clang::dyn_cast< clang::EnumDecl >(decl)) {
+                    return static_cast< bool >(cgctx.enumdecls.lookup(enum_decl));
+                }
+
+                if (decl->isCompleteDefinition()) {
+                    return cgctx.tag_names.count(decl);
+                }
+
+                return static_cast< bool >(cgctx.typedecls.lookup(decl));
+            }
+
+            if (auto arr = clang::dyn_cast< clang::ArrayType >(type)) {
+                return tags_emitted(arr->getElementType(), cgctx);
+            }
+
+            if (auto ptr = clang::dyn_cast< clang::PointerType >(type)) {
+                return tags_emitted(ptr->getPointeeType(), cgctx);
+            }
+
+            return true;
+        }
+
+        //
+        // Finds expressions of a declaration referring to declarations outside
+        // of its file, e.g., an array size or an enumerator value given by an
+        // enumerator or sizeof of a type declared elsewhere. Their values are
+        // folded into the generated operations, but are not a part of the
+        // header key. Types outside of expressions are referenced by name and
+        // only anonymous ones, named by the translation unit, are a concern.
+        //
+        struct context_dependence : clang::RecursiveASTVisitor< context_dependence > {
+            using base = clang::RecursiveASTVisitor< context_dependence >;
+
+            context_dependence(const clang::SourceManager &sm, clang::FileID file)
+                : sm(sm), file(file)
+            {}
+
+            bool TraverseStmt(clang::Stmt *stmt, DataRecursionQueue *queue = nullptr) {
+                ++in_expr;
+                auto result = base::TraverseStmt(stmt, queue);
+                --in_expr;
+                return result;
+            }
+
+            bool VisitDeclRefExpr(clang::DeclRefExpr *expr) { return check(expr->getDecl()); }
+
+            bool VisitTagTypeLoc(clang::TagTypeLoc tl) {
+                auto decl = tl.getDecl();
+                if (in_expr || (!decl->getIdentifier() && !decl->getTypedefNameForAnonDecl())) {
+                    return check(decl);
+                }
+                return true;
+            }
+
+            bool VisitTypedefTypeLoc(clang::TypedefTypeLoc tl) {
+                return in_expr ? check(tl.getTypedefNameDecl()) : true;
+            }
+
+            // Stops the traversal at the first outside declaration.
+            bool check(const clang::Decl *decl) {
+                auto loc = decl->getLocation();
+                if (decl->isImplicit() || loc.isInvalid()) {
+                    return true;
+                }
+
+                dependent = sm.getFileID(sm.getExpansionLoc(loc)) != file;
+                return !dependent;
+            }
+
+            const clang::SourceManager &sm;
+            clang::FileID file;
+            unsigned in_expr = 0;
+            bool dependent = false;
+        };
+
+        bool depends_on_context(clang::Decl *decl, const clang::SourceManager &sm) {
+            // Only declarations without a body are cached.
+            if (auto fn = clang::dyn_cast< clang::FunctionDecl >(decl)) {
+                if (fn->doesThisDeclarationHaveABody()) {
+                    return false;
+                }
+            } else if (!clang::isa< clang::TypedefDecl, clang::TagDecl >(decl)) {
+                return false;
+            }
+
+            context_dependence visitor(sm, sm.getFileID(sm.getExpansionLoc(decl->getLocation())));
+            visitor.TraverseDecl(decl);
+            return visitor.dependent;
+        }
+
+    } // namespace
+
+    //
+    // Keys headers by their path, content and the macro definitions that
+    // precede them. Macro definitions are folded into a running hash in the
+    // order they appear, which keeps the key independent of the unrelated
+    // parts of the translation unit that follow the inclusion.
+    //
+    struct header_tracker : clang::PPCallbacks {
+        header_tracker(header_cache &cache, clang::Preprocessor &pp)
+            : cache(cache), pp(pp)
+        {}
+
+        void MacroDefined(const clang::Token &name, const clang::MacroDirective *md) override {
+            macros.add("define");
+            macros.add(pp.getSpelling(name));
+
+            auto info = md->getMacroInfo();
+            if (info->isFunctionLike()) {
+                macros.add(info->getNumParams());
+                for (auto param : info->params()) {
+                    macros.add(param->getName());
+                }
+                macros.add(info->isVariadic());
+            }
+
+            for (const auto &tok : info->tokens()) {
+                macros.add(pp.getSpelling(tok));
+            }
+        }
+
+        void MacroUndefined(
+            const clang::Token &name, const clang::MacroDefinition &,
+            const clang::MacroDirective *
+        ) override {
+            macros.add("undef");
+            macros.add(pp.getSpelling(name));
+        }
+
+        void FileChanged(
+            clang::SourceLocation loc, FileChangeReason reason,
+            clang::SrcMgr::CharacteristicKind, clang::FileID
+        ) override {
+            if (reason != EnterFile) {
+                return;
+            }
+
+            auto &sm = pp.getSourceManager();
+            auto fid = sm.getFileID(loc);
+            if (fid == sm.getMainFileID()) {
+                return;
+            }
+
+            auto file = sm.getFileEntryForID(fid);
+            if (!file) {
+                return;
+            }
+
+            auto [it, inserted] = cache.headers.try_emplace(file);
+            auto &hdr = it->second;
+
+            // Headers without include guards may declare different things on
+            // every entry.
+            if (!inserted) {
+                hdr.cacheable = false;
+                return;
+            }
+
+            auto content = llvm::BLAKE3::hash(
+                llvm::arrayRefFromStringRef(sm.getBufferOrFake(fid).getBuffer())
+            );
+
+            key_hasher key;
+            key.add(cache.seed_hash);
+            key.add(file->tryGetRealPathName());
+            key.add(llvm::toHex(content));
+            key.add(macros.final());
+
+            hdr.key = key.final();
+        }
+
+        header_cache &cache;
+        clang::Preprocessor &pp;
+        key_hasher macros;
+    };
+
+    header_cache::header_cache(string_ref dir, std::string seed)
+        : dir(dir.str()), seed_hash(std::move(seed))
+    {}
+
+    std::unique_ptr< clang::PPCallbacks > header_cache::make_tracker(clang::Preprocessor &pp) {
+        return std::make_unique< header_tracker >(*this, pp);
+    }
+
+    auto header_cache::get_header(clang::SourceLocation loc, const clang::SourceManager &sm)
+        -> header *
+    {
+        if (loc.isInvalid()) {
+            return nullptr;
+        }
+
+        auto fid = sm.getFileID(sm.getExpansionLoc(loc));
+        if (fid == sm.getMainFileID()) {
+            return nullptr;
+        }
+
+        auto file = sm.getFileEntryForID(fid);
+        if (!file) {
+            return nullptr;
+        }
+
+        auto it = headers.find(file);
+        if (it == headers.end() || !it->second.cacheable || it->second.key.empty()) {
+            return nullptr;
+        }
+
+        return &it->second;
+    }
+
+    void header_cache::load(header &hdr, mcontext_t &mctx) {
+        if (hdr.looked_up) {
+            return;
+        }
+
+        hdr.looked_up = true;
+
+        auto entry = read_module_entry(cache_entry_path(dir, hdr.key, ".mlirbc"), mctx);
+        if (!entry) {
+            return;
+        }
+
+        for (auto &op : entry->getBody()->getOperations()) {
+            if (auto name = symbol_name(&op)) {
+                hdr.ops.try_emplace(op_key(op.getName().getStringRef(), *name), &op);
+            }
+        }
+
+        hdr.entry = std::move(entry);
+    }
+
+    operation header_cache::clone(operation op, cg::codegen_context &cgctx) {
+        auto body = cgctx.mod->getBody();
+        mlir::OpBuilder bld(body, body->end());
+        return bld.clone(*op);
+    }
+
+    void header_cache::handle(
+        clang::Decl *decl, cg::codegen_context &cgctx, llvm::function_ref< void() > generate
+    ) {
+        const auto &sm = cgctx.actx.getSourceManager();
+        auto hdr = get_header(decl->getLocation(), sm);
+        if (!hdr || depends_on_context(decl, sm)) {
+            return generate();
+        }
+
+        load(*hdr, cgctx.mctx);
+        if (hdr->entry) {
+            if (!reuse(decl, *hdr, cgctx)) {
+                generate();
+            }
+            return;
+        }
+
+        // Top-level operations of the declaration are appended to the module.
+        auto body = cgctx.mod->getBody();
+        operation last = body->empty() ? nullptr : &body->back();
+
+        generate();
+
+        auto key = mlir::StringAttr::get(&cgctx.mctx, hdr->key);
+        auto it  = last ? std::next(last->getIterator()) : body->begin();
+        for (; it != body->end(); ++it) {
+            if (is_cacheable_op(&*it)) {
+                it->setAttr(header_key_attr, key);
+            }
+        }
+    }
+
+    bool header_cache::reuse(clang::Decl *decl, header &hdr, cg::codegen_context &cgctx) {
+        if (decl->isTemplated()) {
+            return false;
+        }
+
+        if (auto def = clang::dyn_cast< clang::TypedefDecl >(decl)) {
+            return reuse_typedef(def, hdr, cgctx);
+        }
+
+        if (auto rec = clang::dyn_cast< clang::RecordDecl >(decl)) {
+            return reuse_record(rec, hdr, cgctx);
+        }
+
+        if (auto en = clang::dyn_cast< clang::EnumDecl >(decl)) {
+            return reuse_enum(en, hdr, cgctx);
+        }
+
+        if (auto fn = clang::dyn_cast< clang::FunctionDecl >(decl)) {
+            return reuse_function(fn, hdr, cgctx);
+        }
+
+        return false;
+    }
+
+    bool header_cache::reuse_typedef(
+        const clang::TypedefDecl *decl, header &hdr, cg::codegen_context &cgctx
+    ) {
+        auto underlying = decl->getUnderlyingType();
+        if (!clang::isa< clang::FunctionType >(underlying) && !tags_emitted(underlying, cgctx)) {
+            return false;
+        }
+
+        auto op = hdr.ops.lookup(op_key(hl::TypeDefOp::getOperationName(), decl->getName()));
+        if (!op) {
+            return false;
+        }
+
+        cgctx.declare(decl, [&] { return mlir::cast< hl::TypeDefOp >(clone(op, cgctx)); });
+        return true;
+    }
+
+    bool header_cache::reuse_record(
+        const clang::RecordDecl *decl, header &hdr, cg::codegen_context &cgctx
+    ) {
+        if (clang::isa< clang::CXXRecordDecl >(decl) || !decl->getIdentifier()) {
+            return false;
+        }
+
+        if (!decl->isCompleteDefinition()) {
+            auto op = hdr.ops.lookup(op_key(hl::TypeDeclOp::getOperationName(), decl->getName()));
+            if (!op) {
+                return false;
+            }
+
+            const clang::TypeDecl *type_decl = decl;
+            cgctx.declare(type_decl, [&] {
+                return mlir::cast< hl::TypeDeclOp >(clone(op, cgctx));
+            });
+            return true;
+        }
+
+        auto mnemonic = decl->isUnion()
+            ? hl::UnionDeclOp::getOperationName()
+            : hl::StructDeclOp::getOperationName();
+
+        auto op = hdr.ops.lookup(op_key(mnemonic, cgctx.decl_name(decl)));
+        if (!op) {
+            return false;
+        }
+
+        clone(op, cgctx);
+        return true;
+    }
+
+    bool header_cache::reuse_enum(
+        const clang::EnumDecl *decl, header &hdr, cg::codegen_context &cgctx
+    ) {
+        if (!decl->isFirstDecl() || !decl->isComplete() || !decl->getIdentifier()) {
+            return false;
+        }
+
+        auto op = hdr.ops.lookup(op_key(hl::EnumDeclOp::getOperationName(), decl->getName()));
+        if (!op) {
+            return false;
+        }
+
+        auto constants = [] (hl::EnumDeclOp op) {
+            llvm::StringMap< hl::EnumConstantOp > result;
+            for (auto con : op.getConstants().front().getOps< hl::EnumConstantOp >()) {
+                result.try_emplace(con.getName(), con);
+            }
+            return result;
+        };
+
+        auto cached = constants(mlir::cast< hl::EnumDeclOp >(op));
+        for (auto con : decl->enumerators()) {
+            auto cached_con = cached.lookup(con->getName());
+            if (!cached_con) {
+                return false;
+            }
+
+            auto value = mlir::dyn_cast< core::IntegerAttr >(cached_con.getValue());
+            if (!value || !llvm::APSInt::isSameValue(value.getValue(), con->getInitVal())) {
+                return false;
+            }
+        }
+
+        auto enum_op = cgctx.declare(decl, [&] {
+            return mlir::cast< hl::EnumDeclOp >(clone(op, cgctx));
+        });
+
+        auto cloned = constants(enum_op);
+        for (auto con : decl->enumerators()) {
+            cgctx.declare(con, [&] { return cloned.lookup(con->getName()); });
+        }
+
+        return true;
+    }
+
+    bool header_cache::reuse_function(
+        const clang::FunctionDecl *decl, header &hdr, cg::codegen_context &cgctx
+    ) {
+        if (decl->doesThisDeclarationHaveABody() || decl->isConsteval()
+            || decl->isMultiVersion() || decl->doesDeclarationForceExternallyVisibleDefinition()
+        ) {
+            return false;
+        }
+
+        auto mangled = cgctx.get_mangled_name(decl);
+        if (cgctx.lookup_function(mangled, false) || cgctx.get_global_value(mangled)) {
+            return false;
+        }
+
+        auto op = hdr.ops.lookup(op_key(hl::FuncOp::getOperationName(), mangled.name));
+        if (!op || !mlir::cast< hl::FuncOp >(op).isDeclaration()) {
+            return false;
+        }
+
+        cgctx.declare(mangled, [&] { return mlir::cast< hl::FuncOp >(clone(op, cgctx)); });
+
+        // As for a generated prototype, a deferred definition of the function
+        // is now referenced.
+        auto &deferred = cgctx.deferred_decls;
+        if (auto it = deferred.find(mangled); it != deferred.end()) {
+            cgctx.add_deferred_decl_to_emit(it->second);
+            deferred.erase(it);
+        }
+
+        return true;
+    }
+
+    void header_cache::store(cg::codegen_context &cgctx) {
+        // Collect and unmark the operations generated for headers, the marks
+        // must not leak into the output.
+        llvm::StringMap< std::vector< operation > > generated;
+        for (auto &op : cgctx.mod->getBody()->getOperations()) {
+            if (auto key = op.getAttrOfType< mlir::StringAttr >(header_key_attr)) {
+                generated[key.getValue()].push_back(&op);
+                op.removeAttr(header_key_attr);
+            }
+        }
+
+        for (auto &[file, hdr] : headers) {
+            if (!hdr.cacheable || hdr.entry) {
+                continue;
+            }
+
+            auto it = generated.find(hdr.key);
+            if (it == generated.end()) {
+                continue;
+            }
+
+            std::vector< operation > ops;
+            bool anonymous = false;
+            for (auto op : it->second) {
+                // A prototype may have been completed by a definition since.
+                if (!is_cacheable_op(op)) {
+                    continue;
+                }
+
+                // Names of anonymous tags differ between translation units.
+                auto name = symbol_name(op);
+                if (!name || is_anonymous(*name)) {
+                    anonymous = true;
+                    break;
+                }
+
+                ops.push_back(op);
+            }
+
+            if (anonymous || ops.empty()) {
+                continue;
+            }
+
+            mlir::OpBuilder bld(&cgctx.mctx);
+            owning_module_ref entry(vast_module::create(bld.getUnknownLoc()));
+            bld.setInsertionPointToEnd(entry->getBody());
+            for (auto op : ops) {
+                bld.clone(*op);
+            }
+
+            write_module_entry(cache_entry_path(dir, hdr.key, ".mlirbc"), entry.get());
+        }
+    }
+
+} // namespace vast::cc
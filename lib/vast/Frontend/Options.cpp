@@ -4,6 +4,7 @@
 
 VAST_RELAX_WARNINGS
 #include <llvm/ADT/STLExtras.h>
+#include <llvm/Support/Path.h>
 VAST_UNRELAX_WARNINGS
 
 
@@ -19,7 +20,8 @@ namespace vast::cc {
         std::optional< string_ref > get_option_impl(argv_t args, string_ref name) {
             auto is_opt_with_name = [] (auto name) {
                 return [name] (auto arg) {
-                    return name_and_value_view(arg).startswith(name);
+                    auto [opt_name, _] = name_and_value_view(arg).split('=');
+                    return opt_name == name;
                 };
             };
 
@@ -81,4 +83,14 @@ namespace vast::cc {
         return { vargs, rest };
     }
 
+    std::string working_path(const file_system_options &files, string_ref path) {
+        if (files.WorkingDir.empty() || path == "-" || llvm::sys::path::is_absolute(path)) {
+            return path.str();
+        }
+
+        llvm::SmallString< 256 > result(files.WorkingDir);
+        llvm::sys::path::append(result, path);
+        return result.str().str();
+    }
+
 } // namespace vast::cc
@@ -112,8 +112,7 @@ namespace vast::target::llvmir
             mlir_module->removeAttr(core::CoreDialect::getTargetTripleAttrName());
         }
 
-        mlir::registerBuiltinDialectTranslation(*mlir_module.getContext());
-        mlir::registerLLVMDialectTranslation(*mlir_module.getContext());
+        register_vast_to_llvm_ir(*mlir_module.getContext());
 
         return mlir::translateModuleToLLVMIR(mlir_module, llvm_ctx);
     }
@@ -152,6 +151,12 @@ namespace vast::target::llvmir
 
     void register_vast_to_llvm_ir(mcontext_t &mctx)
     {
+        // Contexts are reused across compilations, every append would add
+        // the extensions once more.
+        auto dialect = mctx.getOrLoadDialect< mlir::LLVM::LLVMDialect >();
+        if (dialect->getRegisteredInterface< mlir::LLVMTranslationDialectInterface >())
+            return;
+
         mlir::DialectRegistry registry;
         register_vast_to_llvm_ir(registry);
         mctx.appendDialectRegistry(registry);
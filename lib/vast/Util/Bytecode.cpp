@@ -0,0 +1,81 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/Util/Bytecode.hpp"
+
+VAST_RELAX_WARNINGS
+#include <mlir/Interfaces/FunctionInterfaces.h>
+VAST_UNRELAX_WARNINGS
+
+namespace vast::util {
+
+    namespace {
+        // Function bodies are the only operations loaded lazily, as they
+        // make up most of the module and are isolated from above.
+        bool is_lazy(operation op) { return mlir::isa< mlir::FunctionOpInterface >(op); }
+
+        bool is_eager(operation) { return false; }
+
+    } // namespace
+
+    bool is_bytecode(const llvm::MemoryBuffer &buffer) {
+        return mlir::isBytecode(buffer.getMemBufferRef());
+    }
+
+    lazy_module::lazy_module(std::unique_ptr< llvm::MemoryBuffer > buffer, mcontext_t *ctx)
+        : config(ctx), source_mgr(std::make_shared< llvm::SourceMgr >())
+    {
+        auto ref = buffer->getMemBufferRef();
+        // The source manager keeps the buffer alive until all bodies are loaded.
+        source_mgr->AddNewSourceBuffer(std::move(buffer), llvm::SMLoc());
+        reader = std::make_unique< mlir::BytecodeReader >(
+            ref, config, /* lazyLoad */ true, source_mgr
+        );
+    }
+
+    std::unique_ptr< lazy_module > lazy_module::read(
+        std::unique_ptr< llvm::MemoryBuffer > buffer, mcontext_t *ctx
+    ) {
+        std::unique_ptr< lazy_module > mod(new lazy_module(std::move(buffer), ctx));
+        if (mlir::failed(mod->reader->readTopLevel(&mod->block, is_lazy))) {
+            return nullptr;
+        }
+
+        if (!llvm::hasSingleElement(mod->block) || !mlir::isa< vast_module >(mod->block.front())) {
+            mlir::emitError(mlir::UnknownLoc::get(ctx), "expected a single top-level module");
+            return nullptr;
+        }
+
+        return mod;
+    }
+
+    vast_module lazy_module::get() { return mlir::cast< vast_module >(block.front()); }
+
+    owning_module_ref lazy_module::release() {
+        if (mlir::failed(materialize_all())) {
+            return {};
+        }
+
+        auto mod = get();
+        mod->remove();
+        return mod;
+    }
+
+    logical_result lazy_module::materialize(operation root) {
+        // Collect operations first, as loading modifies the walked regions.
+        llvm::SmallVector< operation > lazy;
+        root->walk([&] (operation op) {
+            if (reader->isMaterializable(op)) {
+                lazy.push_back(op);
+            }
+        });
+
+        for (auto op : lazy) {
+            if (mlir::failed(reader->materialize(op, is_eager))) {
+                return mlir::failure();
+            }
+        }
+
+        return mlir::success();
+    }
+
+} // namespace vast::util
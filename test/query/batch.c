@@ -0,0 +1,28 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: echo '--show-symbols=functions' > %t.q && \
+// RUN: echo '{"show-symbols": "vars", "scope": "foo"}' >> %t.q && \
+// RUN: echo '--symbol-users=a --scope=main' >> %t.q && \
+// RUN: echo '--show-symbols=fun' >> %t.q && \
+// RUN: echo '--show-symbols=vars --scope=bar' >> %t.q && \
+// RUN: echo '--show-symbols=functions' >> %t.q && \
+// RUN: not %vast-query --batch=%t.q %t | %file-check %s
+
+// CHECK-DAG: {"query":0,"symbol":"foo","kind":"hl.func"
+// CHECK-DAG: {"query":0,"symbol":"main","kind":"hl.func"
+// CHECK-DAG: {"query":1,"symbol":"a","kind":"hl.var"
+int foo() {
+    int a;
+    return a;
+}
+
+// CHECK: {"query":2,"user":"{{.*}}hl.ref
+// CHECK: {"query":2,"user":"{{.*}}hl.ref
+// CHECK: {"query":3,"error":"unknown symbol kind 'fun'"}
+// CHECK: {"query":4,"error":"unknown scope 'bar'"}
+// CHECK: {"query":5,"symbol":
+int main()
+{
+    int a = 1, b = 1;
+    int c = a + b;
+    int d = a + 7;
+}
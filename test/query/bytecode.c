@@ -0,0 +1,38 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-opt --emit-bytecode %t -o %t.mlirbc && \
+// RUN: %vast-query --show-symbols=vars %t.mlirbc | \
+// RUN: %file-check %s -check-prefix=FOO-VAR -check-prefix=MAIN-VAR
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-opt --emit-bytecode %t -o %t.mlirbc && \
+// RUN: %vast-query --show-symbols=vars --scope=foo %t.mlirbc | \
+// RUN: %file-check %s -check-prefix=FOO-VAR
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-opt --emit-bytecode %t -o %t.mlirbc && \
+// RUN: %vast-query --show-symbols=functions %t.mlirbc | \
+// RUN: %file-check %s -check-prefix=FUN
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-opt --emit-bytecode %t -o %t.mlirbc && \
+// RUN: %vast-query --symbol-users=a --scope=main %t.mlirbc | \
+// RUN: %file-check %s -check-prefix=MAIN-USE
+
+// FOO-VAR-DAG: hl.var : a
+// FUN-DAG: func : foo
+int foo() {
+    int a;
+    return a;
+}
+
+// MAIN-VAR-DAG: hl.var : a
+// MAIN-VAR-DAG: hl.var : b
+// FUN-DAG: func : main
+// MAIN-USE: hl.ref %0
+// MAIN-USE: hl.ref %0
+int main()
+{
+    int a = 1, b = 1;
+    int c = a + b;
+    int d = a + 7;
+}
@@ -0,0 +1,46 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-query --index -o %t.idx %t && \
+// RUN: %vast-query --show-symbols=vars %t.idx | \
+// RUN: %file-check %s -check-prefix=FOO-VAR -check-prefix=MAIN-VAR
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-query --index -o %t.idx %t && \
+// RUN: %vast-query --show-symbols=vars --scope=foo %t.idx | \
+// RUN: %file-check %s -check-prefix=FOO-VAR
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-query --index -o %t.idx %t && \
+// RUN: %vast-query --show-symbols=functions %t.idx | \
+// RUN: %file-check %s -check-prefix=FUN
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-query --index -o %t.idx %t && \
+// RUN: %vast-query --symbol-users=a --scope=main %t.idx | \
+// RUN: %file-check %s -check-prefix=MAIN-USE
+
+// The first symbol refers to users past the end of the index.
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-query --index -o %t.idx %t && \
+// RUN: printf '\377\377\377\377' | dd of=%t.idx bs=1 seek=60 conv=notrunc 2>/dev/null && \
+// RUN: not %vast-query --show-symbols=vars %t.idx 2>&1 | \
+// RUN: %file-check %s -check-prefix=CORRUPT
+
+// CORRUPT: malformed symbol index
+// FOO-VAR-DAG: hl.var : a
+// FUN-DAG: func : foo
+int foo() {
+    int a;
+    return a;
+}
+
+// MAIN-VAR-DAG: hl.var : a
+// MAIN-VAR-DAG: hl.var : b
+// FUN-DAG: func : main
+// MAIN-USE: hl.ref %0
+// MAIN-USE: hl.ref %0
+int main()
+{
+    int a = 1, b = 1;
+    int c = a + b;
+    int d = a + 7;
+}
@@ -0,0 +1,18 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t.a && \
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t.b && \
+// RUN: %vast-query -j 2 --show-symbols=functions %t.a %t.b | \
+// RUN: %file-check %s -DA=%t.a -DB=%t.b
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t.a && \
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t.b && \
+// RUN: echo %t.a > %t.list && echo %t.b >> %t.list && \
+// RUN: %vast-query --show-symbols=functions --input-list=%t.list | \
+// RUN: %file-check %s -DA=%t.a -DB=%t.b
+
+// CHECK: [[A]] : {{.*}} : foo
+// CHECK: [[A]] : {{.*}} : main
+// CHECK: [[B]] : {{.*}} : foo
+// CHECK: [[B]] : {{.*}} : main
+int foo() { return 0; }
+
+int main() { return foo(); }
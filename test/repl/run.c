@@ -0,0 +1,4 @@
+// RUN: printf "load %s\n run add 40 2\n run add 1 -3\n exit" | %vast-repl | %file-check %s
+// CHECK: 42
+// CHECK: -2
+int add(int a, int b) { return a + b; }
@@ -0,0 +1,3 @@
+enum { N = 4 };
+
+#include "header-cache-context.h"
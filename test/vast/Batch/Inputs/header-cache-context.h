@@ -0,0 +1,5 @@
+#pragma once
+
+struct sized { int data[N]; };
+
+enum shifted { first = N, second };
@@ -0,0 +1,11 @@
+#pragma once
+
+typedef unsigned long size_type;
+
+struct point { int x, y; };
+
+typedef struct point point_t;
+
+enum color { red, green = 4, blue };
+
+int distance(point_t a, point_t b);
@@ -0,0 +1,9 @@
+#pragma once
+
+struct point { int x, y; };
+
+typedef struct point point_t;
+
+int counter = 0;
+
+static inline int norm(point_t p) { return p.x * p.x + p.y * p.y; }
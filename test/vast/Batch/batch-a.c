@@ -0,0 +1,11 @@
+// RUN: rm -rf %t && mkdir -p %t && \
+// RUN: echo '[{"directory": "%t", "command": "cc -c %s -o a.o", "file": "%s"},' > %t/compile_commands.json && \
+// RUN: echo ' {"directory": "%t", "command": "cc -c missing.c -o b.o", "file": "missing.c"}]' >> %t/compile_commands.json && \
+// RUN: not %vast-front --batch %t/compile_commands.json -j 2 -vast-emit-mlir=hl 2> %t/errors && \
+// RUN: %file-check %s --input-file=%t/a.mlir && \
+// RUN: %file-check %s --input-file=%t/errors -check-prefix=ERRORS
+
+// CHECK: hl.func @square
+// ERRORS: error: compilation of 'missing.c' failed
+// ERRORS: error: 1 of 2 translation units failed
+int square(int x) { return x * x; }
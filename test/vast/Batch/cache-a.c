@@ -0,0 +1,15 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %vast-front -vast-emit-mlir=hl -vast-cache-dir=%t/cache %s -o %t/first.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -vast-cache-dir=%t/cache %s -o %t/second.mlir
+// RUN: diff %t/first.mlir %t/second.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -vast-cache-dir=%t/cache -DVALUE=2 %s -o %t/third.mlir
+// RUN: %file-check %s --check-prefix=FIRST --input-file=%t/second.mlir
+// RUN: %file-check %s --check-prefix=THIRD --input-file=%t/third.mlir
+
+#ifndef VALUE
+#define VALUE 1
+#endif
+
+// FIRST: hl.const #core.integer<1> : si32
+// THIRD: hl.const #core.integer<2> : si32
+int value(void) { return VALUE; }
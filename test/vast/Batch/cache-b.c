@@ -0,0 +1,9 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %vast-front -vast-emit-mlir=hl -vast-cache-dir=%t/cache -w %s -o %t/quiet.mlir
+// RUN: not %vast-front -vast-emit-mlir=hl -vast-cache-dir=%t/cache -Wall -Werror %s -o %t/strict.mlir 2>&1 | %file-check %s
+
+// CHECK: error: unused variable 'unused'
+int value(void) {
+    int unused;
+    return 0;
+}
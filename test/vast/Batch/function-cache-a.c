@@ -0,0 +1,23 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %vast-front -vast-emit-mlir=hl -vast-function-cache=%t/fc %s -o %t/first.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -vast-function-cache=%t/fc %s -o %t/second.mlir
+// RUN: sed -e 's/return x + 1;/return x + 7;/' %s > %t/edited.c
+// RUN: %vast-front -vast-emit-mlir=hl -vast-function-cache=%t/fc %t/edited.c -o %t/edited.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -vast-emit-locs -vast-function-cache=%t/locs %s -o %t/locs-first.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -vast-emit-locs -vast-function-cache=%t/locs %s -o %t/locs-second.mlir
+// RUN: diff %t/locs-first.mlir %t/locs-second.mlir
+// RUN: %file-check %s --check-prefixes=CHECK,ORIG --input-file=%t/first.mlir
+// RUN: %file-check %s --check-prefixes=CHECK,ORIG --input-file=%t/second.mlir
+// RUN: %file-check %s --check-prefixes=CHECK,EDITED --input-file=%t/edited.mlir
+
+int counter = 0;
+
+// CHECK: hl.func @next
+// ORIG: hl.const #core.integer<1>
+// EDITED: hl.const #core.integer<7>
+int next(int x) { return x + 1; }
+
+// CHECK: hl.func @step
+// CHECK: hl.call @next
+// CHECK: hl.globref "counter"
+int step(void) { return next(counter); }
@@ -0,0 +1,17 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %vast-front -vast-emit-mlir=hl -vast-header-cache=%t/hc -I %S/Inputs %s -o %t/first.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -vast-header-cache=%t/hc -I %S/Inputs %s -o %t/second.mlir
+// RUN: %file-check %s --input-file=%t/first.mlir
+// RUN: %file-check %s --input-file=%t/second.mlir
+
+#include "header-cache.h"
+
+// CHECK: hl.typedef "size_type"
+// CHECK: hl.struct "point"
+// CHECK: hl.typedef "point_t"
+// CHECK: hl.enum "color"
+// CHECK: hl.func @distance
+// CHECK: hl.func @far
+// CHECK: hl.call @distance
+// CHECK: hl.enumref "blue"
+int far(point_t a) { return distance(a, a) > blue; }
@@ -0,0 +1,16 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %vast-front -vast-emit-mlir=hl -vast-header-cache=%t/hc -I %S/Inputs %S/Inputs/header-cache-context.c -o %t/first.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -vast-header-cache=%t/hc -I %S/Inputs %s -o %t/second.mlir
+// RUN: %file-check %s --input-file=%t/second.mlir
+
+// Declarations of the header depend on the enumerator of the main file, the
+// ones generated for the first translation unit must not be reused.
+
+enum { N = 8 };
+
+#include "header-cache-context.h"
+
+// CHECK: hl.struct "sized"
+// CHECK: hl.field "data" : !hl.array<8, !hl.int>
+// CHECK: hl.enum "shifted"
+// CHECK: hl.enum.const "first" = #core.integer<8> : !hl.int
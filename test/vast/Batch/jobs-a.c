@@ -0,0 +1,9 @@
+// RUN: rm -rf %t && mkdir -p %t && cp %s %t/a.c && cp %s %t/b.c && \
+// RUN: echo 'int broken(void) { return missing; }' > %t/c.c && \
+// RUN: cd %t && %vast-front -c -vast-jobs=2 a.c b.c && \
+// RUN: test -f a.o && test -f b.o && \
+// RUN: not %vast-front -c -vast-jobs=2 a.c c.c b.c 2>&1 | %file-check %s
+
+// CHECK: c.c:1:{{[0-9]+}}: error: use of undeclared identifier 'missing'
+// CHECK-NOT: error
+int square(int x) { return x * x; }
@@ -0,0 +1,14 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %vast-front -x c-header %S/Inputs/pch.h -o %t/pch.h.pch
+// RUN: %vast-front -vast-emit-mlir=hl -include-pch %t/pch.h.pch %s -o %t/pch.mlir
+// RUN: %vast-front -vast-emit-mlir=hl -include %S/Inputs/pch.h %s -o %t/include.mlir
+// RUN: %file-check %s --input-file=%t/pch.mlir
+// RUN: %file-check %s --input-file=%t/include.mlir
+
+// CHECK-DAG: hl.struct "point"
+// CHECK-DAG: hl.typedef "point_t"
+// CHECK-DAG: hl.var @counter
+// CHECK-DAG: hl.func @norm
+// CHECK: hl.func @length
+// CHECK: hl.call @norm
+int length(point_t p) { return norm(p) + counter; }
@@ -0,0 +1,19 @@
+// RUN: rm -rf %t && mkdir -p %t && cp %s %t/input.c
+// RUN: %vast-front --server %t/vast.sock 2> %t/server.log & server=$!; \
+// RUN: trap "kill $server" EXIT; \
+// RUN: for i in $(seq 100); do test -S %t/vast.sock && break; sleep 0.1; done; \
+// RUN: cd %t && env VAST_SERVER=%t/vast.sock %vast-front -c -Wunused-variable -vast-emit-mlir=hl input.c -o out.mlir 2> %t/diags.txt && \
+// RUN: not %vast-front --server %t/vast.sock 2> %t/live.txt
+// RUN: %file-check %s --input-file=%t/server.log --check-prefix=SERVER
+// RUN: %file-check %s --input-file=%t/out.mlir
+// RUN: %file-check %s --input-file=%t/diags.txt --check-prefix=DIAG
+// RUN: %file-check %s --input-file=%t/live.txt --check-prefix=LIVE
+
+// SERVER: vast-front: listening on
+// CHECK: hl.func @unused
+// DIAG: input.c:{{[0-9]+}}:{{[0-9]+}}: warning: unused variable 'x'
+// LIVE: error: a server is already listening on
+int unused(void) {
+    int x;
+    return 0;
+}
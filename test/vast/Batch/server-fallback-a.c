@@ -0,0 +1,5 @@
+// RUN: rm -f %t.sock && \
+// RUN: env VAST_SERVER=%t.sock %vast-front %s -vast-emit-mlir=hl -o - | %file-check %s
+
+// CHECK: hl.func @square
+int square(int x) { return x * x; }
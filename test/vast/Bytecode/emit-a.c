@@ -0,0 +1,13 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && \
+// RUN: %vast-cc1 -vast-emit-mlir=hl -vast-emit-mlir-bytecode %s -o %t.mlirbc && \
+// RUN: %vast-opt %t.mlirbc | diff -B %t -
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl -vast-emit-mlir-bytecode %s -o %t.mlirbc && \
+// RUN: %vast-query --show-symbols=functions %t.mlirbc | %file-check %s -check-prefix=QUERY
+
+// RUN: %vast-cc1 -vast-emit-mlir=hl -vast-emit-locs -vast-emit-mlir-bytecode %s -o %t.mlirbc && \
+// RUN: %vast-opt --mlir-print-debuginfo %t.mlirbc | %file-check %s -check-prefix=LOCS
+
+// QUERY: func : square
+// LOCS: loc("{{.*}}emit-a.c":{{[0-9]+}}:{{[0-9]+}})
+int square(int x) { return x * x; }
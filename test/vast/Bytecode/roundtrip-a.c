@@ -0,0 +1,38 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && %vast-opt --emit-bytecode %t | %vast-opt | diff -B %t -
+
+typedef unsigned long size;
+typedef const volatile int cvint;
+
+enum color { red, green, blue };
+
+struct node {
+    struct node *next;
+    const char *name;
+    unsigned short flags;
+    int values[4];
+    enum color color;
+};
+
+union number { int i; float f; double d; };
+
+size count;
+cvint limit = 10;
+struct node nodes[16];
+char *restrict buffer;
+const long long *const *table;
+unsigned char bytes[2][3];
+__int128 wide;
+
+void (*callback)(int, ...);
+
+int sum(const int *values, size n) {
+    int result = 0;
+    for (size i = 0; i < n; ++i)
+        result += values[i];
+    return result;
+}
+
+double scale(float f, long double ld, union number num) {
+    _Bool flag = f > 0;
+    return flag ? f * ld : num.d;
+}
@@ -0,0 +1,18 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && %vast-opt --emit-bytecode %t | %vast-opt | diff -B %t -
+
+const char *greeting = "hello\n\t\"world\"";
+unsigned long long big = 18446744073709551615ULL;
+long long negative = -9223372036854775807LL;
+short small = -42;
+float f = 0.1f;
+double d = 1e308;
+long double ld = 0.5L;
+
+void nothing(void) {}
+
+int constants(void) {
+    _Bool b = 1;
+    char c = 'x';
+    nothing();
+    return b + c;
+}
@@ -0,0 +1,5 @@
+// RUN: %vast-opt --emit-bytecode %s | %vast-opt | %file-check %s
+
+// CHECK: meta.test = #meta.id<42>
+module attributes {meta.test = #meta.id<42>} {
+}
@@ -0,0 +1,11 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: %vast-front -c -vast-emit=hl:%t/out.hl.mlir,llvm-mlir:%t/out.llvm.mlir,llvm:%t/out.ll,obj:%t/out.o %s
+// RUN: %file-check %s --check-prefix=HL --input-file=%t/out.hl.mlir
+// RUN: %file-check %s --check-prefix=MLIR --input-file=%t/out.llvm.mlir
+// RUN: %file-check %s --check-prefix=IR --input-file=%t/out.ll
+// RUN: test -s %t/out.o
+
+// HL: hl.func @square
+// MLIR: llvm.func @square
+// IR: define {{.*}}i32 @square(i32
+int square(int x) { return x * x; }
@@ -0,0 +1,15 @@
+// RUN: %vast-front -vast-verify-functions -o %t %s && (%t; test $? -eq 42)
+// RUN: %vast-front -vast-emit-mlir=hl -vast-verify-functions %s -o %t.mlir
+// RUN: %file-check %s --input-file=%t.mlir
+
+// CHECK: hl.func @add
+int add(int a, int b) { return a + b; }
+
+int counter = 0;
+
+// CHECK: hl.func @main
+// CHECK: hl.call @add
+int main() {
+    counter = add(20, 22);
+    return counter;
+}
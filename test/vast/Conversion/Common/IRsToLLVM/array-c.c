@@ -0,0 +1,13 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-irs-to-llvm | %file-check %s
+
+// CHECK: llvm.mlir.global internal constant @table(dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15]> : tensor<16xi32>) {addr_space = 0 : i32} : !llvm.array<16 x i32>
+const int table[16] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+void count()
+{
+    // CHECK: [[C:%[0-9]+]] = llvm.mlir.constant(dense<{{.*}}> : tensor<16xf32>) : !llvm.array<16 x f32>
+    // CHECK: llvm.store [[C]], {{%[0-9]+}} : !llvm.ptr<array<16 x f32>>
+    float x[16] = { 1.0f, 2.0f, 3.0f, 4.0f };
+}
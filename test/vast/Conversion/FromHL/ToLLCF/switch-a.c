@@ -0,0 +1,29 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-dce --vast-hl-lower-types --vast-hl-to-ll-cf | %file-check %s
+// RUN: %vast-cc1 -vast-emit-mlir=llvm %s -o - | %file-check %s -check-prefix=LLVM
+
+// CHECK-LABEL: hl.func @dispatch
+// LLVM-LABEL: llvm.func @dispatch
+int dispatch(int op)
+{
+    int acc = 0;
+    // CHECK: ll.switch [[V:%[0-9]+]] : si32, ^[[DEF:bb[0-9]+]] [^[[C1:bb[0-9]+]], ^[[C2:bb[0-9]+]], ^[[C3:bb[0-9]+]]] {case_values = dense<[1, 2, 3]> : tensor<3xi32>}
+    // LLVM: llvm.switch {{%[0-9]+}} : i32, ^{{bb[0-9]+}} [
+    // LLVM-NEXT: 1: ^{{bb[0-9]+}},
+    // LLVM-NEXT: 2: ^{{bb[0-9]+}},
+    // LLVM-NEXT: 3: ^{{bb[0-9]+}}
+    // LLVM-NEXT: ]
+    switch (op) {
+        // CHECK: ^[[C1]]:
+        // CHECK: ll.br ^[[C2]]
+        case 1: acc += 1;
+        // CHECK: ^[[C2]]:
+        // CHECK: ll.br ^[[TAIL:bb[0-9]+]]
+        case 2: acc += 2; break;
+        // CHECK: ^[[C3]]:
+        // CHECK: ^[[DEF]]:
+        case 3:
+        default: acc = 7;
+    }
+    // CHECK: ^[[TAIL]]:
+    return acc;
+}
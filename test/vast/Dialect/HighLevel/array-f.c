@@ -0,0 +1,17 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %file-check %s
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o %t && %vast-opt %t | diff -B %t -
+
+// CHECK: hl.var "table" : !hl.lvalue<!hl.array<16, !hl.int< unsigned, const >>> = {
+// CHECK:   [[V1:%[0-9]+]] = hl.dense_initlist dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15]> : tensor<16xi32> : !hl.array<16, !hl.int< unsigned, const >>
+// CHECK:   hl.value.yield [[V1]]
+const unsigned table[16] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+};
+
+// CHECK: hl.var "padded" : !hl.lvalue<!hl.array<20, !hl.double>> = {
+// CHECK:   hl.dense_initlist dense<[1.000000e+00, -2.500000e+00, 3.000000e+00, 0.000000e+00, {{.*}}]> : tensor<20xf64>
+double padded[20] = { 1.0, -2.5, 3 };
+
+// CHECK: hl.var "small" : !hl.lvalue<!hl.array<3, !hl.int>> = {
+// CHECK:   hl.initlist
+int small[3] = { 1, 2, 3 };
@@ -0,0 +1,17 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl -vast-strlit-resource-threshold=16 %s -o - | %file-check %s
+// RUN: %vast-cc1 -vast-emit-mlir=llvm -vast-strlit-resource-threshold=16 %s -o - | %file-check %s -check-prefix=LLVM
+// RUN: %vast-cc1 -vast-emit-mlir=hl -vast-strlit-resource-threshold=16 %s -o - | sed '/^{-#/,$d' | \
+// RUN: not %vast-opt --vast-hl-lower-types --vast-hl-to-ll-cf --vast-hl-to-ll-vars --vast-irs-to-llvm 2>&1 | %file-check %s -check-prefix=MISSING
+
+// CHECK: hl.const #core.strlit<"short"> : !hl.lvalue<!hl.array<6, !hl.char>>
+// LLVM: llvm.mlir.global internal constant @vast.strlit.constant_{{[0-9]+}}("short\00")
+const char *short_str = "short";
+
+// CHECK: hl.const #core.strlit_resource<vast_strlit{{.*}}> : !hl.lvalue<!hl.array<33, !hl.char>>
+// LLVM: llvm.mlir.global internal constant @vast.strlit.constant_{{[0-9]+}}("a string stored in a blob.......\00")
+// MISSING: error: string literal resource has no data
+const char *long_str = "a string stored in a blob.......";
+
+// CHECK: {-#
+// CHECK: dialect_resources
+// CHECK: vast_strlit{{.*}}: "__elided__"
@@ -0,0 +1,82 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-canonicalize | %file-check %s
+
+// CHECK-LABEL: hl.func @arith
+int arith() {
+    // CHECK: hl.const #core.integer<7> : !hl.int
+    // CHECK-NOT: hl.add
+    // CHECK-NOT: hl.mul
+    return 1 + 2 * 3;
+}
+
+// CHECK-LABEL: hl.func @wrap
+unsigned wrap() {
+    // CHECK: hl.const #core.integer<2147483648> : !hl.int< unsigned >
+    // CHECK-NOT: hl.bin.shl
+    return 1u << 31;
+}
+
+// CHECK-LABEL: hl.func @cmp
+int cmp() {
+    // CHECK: hl.const #core.integer<1> : !hl.int
+    // CHECK-NOT: hl.cmp
+    return -1 < 0;
+}
+
+// CHECK-LABEL: hl.func @unsigned_cmp
+int unsigned_cmp() {
+    // CHECK: hl.const #core.integer<0> : !hl.int
+    // CHECK-NOT: hl.cmp
+    return -1 < 0u;
+}
+
+// CHECK-LABEL: hl.func @div_by_zero
+int div_by_zero() {
+    // CHECK: hl.sdiv
+    return 1 / 0;
+}
+
+// CHECK-LABEL: hl.func @not_constant
+int not_constant(int x) {
+    // CHECK: hl.add
+    return x + 1;
+}
+
+// CHECK-LABEL: hl.func @signed_overflow
+int signed_overflow() {
+    // CHECK: hl.add
+    return 2147483647 + 1;
+}
+
+// CHECK-LABEL: hl.func @signed_shift_overflow
+int signed_shift_overflow() {
+    // CHECK: hl.bin.shl
+    return 1 << 31;
+}
+
+// CHECK-LABEL: hl.func @unused_constant
+void unused_constant() {
+    // CHECK: hl.const #core.integer<5> : !hl.int
+    5;
+}
+
+// CHECK-LABEL: hl.func @and_short_circuit
+int and_short_circuit() {
+    // CHECK: hl.const #core.integer<0> : !hl.int
+    // CHECK-NOT: hl.bin.land
+    // CHECK-NOT: hl.add
+    return 0 && (1 + 2);
+}
+
+// CHECK-LABEL: hl.func @or_short_circuit
+int or_short_circuit() {
+    // CHECK: hl.const #core.integer<1> : !hl.int
+    // CHECK-NOT: hl.bin.lor
+    // CHECK-NOT: hl.mul
+    return 1 || (2 * 3);
+}
+
+// CHECK-LABEL: hl.func @minus_overflow
+int minus_overflow() {
+    // CHECK: hl.minus
+    return -(-2147483647 - 1);
+}
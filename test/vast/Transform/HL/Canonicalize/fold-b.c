@@ -0,0 +1,33 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-canonicalize | %file-check %s
+
+// CHECK-LABEL: hl.func @trunc
+char trunc() {
+    // CHECK: hl.const #core.integer<44> : !hl.char
+    // CHECK-NOT: hl.implicit_cast
+    return 300;
+}
+
+// CHECK-LABEL: hl.func @to_float
+double to_float() {
+    // CHECK: hl.const #core.float<2.500000e+00> : !hl.double
+    // CHECK-NOT: hl.fadd
+    return 2 + 0.5;
+}
+
+// CHECK-LABEL: hl.func @logic
+int logic(int x) {
+    // CHECK: hl.const #core.integer<0> : !hl.int
+    // CHECK-NOT: hl.bin.land
+    return 0 && x;
+}
+
+// CHECK: hl.var "g"
+// CHECK-NEXT: hl.const #core.integer<8> : !hl.int
+// CHECK-NEXT: hl.value.yield
+int g = 1 << 3;
+
+// CHECK-LABEL: hl.func @float_overflow
+float float_overflow() {
+    // CHECK: hl.implicit_cast {{.*}} FloatingCast
+    return 1e300;
+}
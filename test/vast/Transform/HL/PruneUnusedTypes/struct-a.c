@@ -0,0 +1,19 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-prune-unused-types | %file-check %s
+
+// CHECK-NOT: hl.struct "unused"
+struct unused { int a; };
+
+// CHECK: hl.struct "inner"
+struct inner { int a; };
+
+// CHECK: hl.struct "outer"
+struct outer { struct inner i; };
+
+// CHECK-NOT: hl.enum "unused_color"
+enum unused_color { RED, GREEN };
+
+// CHECK: hl.enum "shape"
+enum shape { CIRCLE, SQUARE };
+
+// CHECK: hl.func @area
+int area(struct outer *o) { return SQUARE; }
@@ -0,0 +1,16 @@
+// RUN: %vast-cc1 -vast-emit-mlir=hl %s -o - | %vast-opt --vast-hl-prune-unused-types | %file-check %s
+
+// CHECK-NOT: hl.typedef "UNUSED"
+typedef int UNUSED;
+
+// CHECK: hl.typedef "INT" : !hl.int
+typedef int INT;
+
+// CHECK: hl.typedef "IINT" : !hl.elaborated<!hl.typedef<"INT">>
+typedef INT IINT;
+
+// CHECK-NOT: hl.typedef "UNUSED_ALIAS"
+typedef IINT UNUSED_ALIAS;
+
+// CHECK: hl.func @foo
+IINT foo(void) { return 0; }
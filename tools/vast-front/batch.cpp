@@ -0,0 +1,403 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+//===----------------------------------------------------------------------===//
+//
+// Batch mode of vast-front: compiles all translation units of a compilation
+// database in-process on a pool of worker threads.
+//
+//===----------------------------------------------------------------------===//
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <clang/Tooling/JSONCompilationDatabase.h>
+#include <llvm/Support/BuryPointer.h>
+#include <llvm/Support/CrashRecoveryContext.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/VirtualFileSystem.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Frontend/Driver.hpp"
+#include "vast/Frontend/Options.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace vast::cc {
+
+    extern int cc1_job(
+        const vast_args &vargs, argv_t ccargs, arg_t tool, void *main_addr,
+        mcontext_t *mctx, llvm::raw_ostream &os
+    );
+
+    using job_args = std::vector< std::string >;
+
+    // Expands a command line into jobs using the clang driver. Paths are
+    // resolved relative to `directory` without changing the working directory
+    // of the process, cc1 jobs get it as their -working-directory.
+    std::optional< std::vector< job_args > > expand_jobs(
+        argv_t cmd_args, string_ref directory, const std::string &driver_path,
+        llvm::raw_ostream &os
+    ) {
+        auto working_directory = directory.str();
+
+        argv_storage args(cmd_args.begin(), cmd_args.end());
+        args.push_back("-working-directory");
+        args.push_back(working_directory.c_str());
+
+        llvm_cnt_ptr< clang::DiagnosticOptions > diag_opts = new clang::DiagnosticOptions();
+        clang::TextDiagnosticPrinter printer(os, diag_opts.get());
+        diagnostics_engine engine(make_ids(), diag_opts, &printer, false);
+
+        llvm_cnt_ptr< llvm::vfs::FileSystem > vfs(llvm::vfs::createPhysicalFileSystem().release());
+        clang_driver drv(
+            driver_path, llvm::sys::getDefaultTargetTriple(), engine, "vast compiler", vfs
+        );
+        drv.ResourceDir = CLANG_RESOURCE_DIR;
+
+        auto target_and_mode = toolchain::getTargetAndModeFromProgramName(args[0]);
+        drv.setTargetAndMode(target_and_mode);
+
+        std::set< std::string > saved_string;
+        insert_target_and_mode_args(target_and_mode, args, saved_string);
+
+        std::unique_ptr< clang_compilation > comp(drv.BuildCompilation(args));
+        if (!comp || comp->containsError()) {
+            return std::nullopt;
+        }
+
+        std::vector< job_args > jobs;
+        for (const auto &job : comp->getJobs()) {
+            const auto &arguments = job.getArguments();
+            job_args result(arguments.begin(), arguments.end());
+
+            bool is_cc1 = !result.empty() && result.front() == "-cc1";
+            if (is_cc1 && llvm::find(result, "-working-directory") == result.end()) {
+                result.push_back("-working-directory");
+                result.push_back(working_directory);
+            }
+
+            jobs.push_back(std::move(result));
+        }
+
+        return jobs;
+    }
+
+    // A context reused by consecutive compilations is recycled after this
+    // many of them, or sooner if the process grows past the memory bound, to
+    // drop types and attributes uniqued by earlier compilations.
+    constexpr unsigned context_max_compilations = 100;
+    constexpr std::size_t context_max_malloc_usage = std::size_t(4) << 30;
+
+    bool should_recycle_context(unsigned compilations) {
+        return compilations >= context_max_compilations
+            || llvm::sys::Process::GetMallocUsage() > context_max_malloc_usage;
+    }
+
+    namespace {
+
+        using compile_command = clang::tooling::CompileCommand;
+
+        struct batch_options {
+            std::string database;
+            unsigned jobs = 0;
+            vast_args vargs;
+        };
+
+        enum class job_status { ok, failed, crashed };
+
+        struct job_result {
+            job_status status = job_status::ok;
+            std::string diagnostics;
+        };
+
+        std::optional< unsigned > parse_jobs(string_ref value) {
+            unsigned jobs = 0;
+            if (value.getAsInteger(10, jobs)) {
+                return std::nullopt;
+            }
+            return jobs;
+        }
+
+        // vast-front --batch <compile_commands.json> [-j <N>] [-vast-* options]
+        std::optional< batch_options > parse_batch_options(argv_t args, llvm::raw_ostream &os) {
+            batch_options opts;
+
+            for (std::size_t i = 2; i < args.size(); ++i) {
+                auto arg = string_ref(args[i]);
+
+                if (arg.startswith(vast_option_prefix)) {
+                    opts.vargs.push_back(args[i]);
+                } else if (arg == "-j" && i + 1 < args.size()) {
+                    auto jobs = parse_jobs(args[++i]);
+                    if (!jobs) {
+                        os << "error: invalid number of jobs '" << args[i] << "'\n";
+                        return std::nullopt;
+                    }
+                    opts.jobs = *jobs;
+                } else if (arg.startswith("-j")) {
+                    auto jobs = parse_jobs(arg.drop_front(2));
+                    if (!jobs) {
+                        os << "error: invalid number of jobs '" << arg << "'\n";
+                        return std::nullopt;
+                    }
+                    opts.jobs = *jobs;
+                } else if (opts.database.empty()) {
+                    opts.database = arg.str();
+                } else {
+                    os << "error: unexpected batch argument '" << arg << "'\n";
+                    return std::nullopt;
+                }
+            }
+
+            if (opts.database.empty()) {
+                os << "error: --batch expects a compilation database\n";
+                return std::nullopt;
+            }
+
+            return opts;
+        }
+
+        // Suffix of the output requested by vast options, the command output
+        // path gets it instead of its own extension.
+        std::optional< string_ref > output_suffix(const vast_args &vargs) {
+            if (vargs.has_option(opt::emit_mlir_bytecode)) {
+                return "mlirbc";
+            }
+
+            if (vargs.has_option(opt::emit_mlir)) {
+                return "mlir";
+            }
+
+            if (vargs.has_option(opt::emit_llvm)) {
+                return "ll";
+            }
+
+            if (vargs.has_option(opt::emit_asm)) {
+                return "s";
+            }
+
+            if (vargs.has_option(opt::emit_obj)) {
+                return "o";
+            }
+
+            return std::nullopt;
+        }
+
+        // Expands a compile command into cc1 jobs, other jobs, e.g., the
+        // linker, are not run in batch mode.
+        std::optional< std::vector< job_args > > expand_command(
+            const compile_command &cmd, const std::string &driver_path,
+            const vast_args &vargs, llvm::raw_ostream &os
+        ) {
+            if (cmd.CommandLine.empty()) {
+                return std::nullopt;
+            }
+
+            argv_storage args;
+            for (const auto &arg : cmd.CommandLine) {
+                args.push_back(arg.c_str());
+            }
+
+            auto expanded = expand_jobs(args, cmd.Directory, driver_path, os);
+            if (!expanded) {
+                return std::nullopt;
+            }
+
+            auto suffix = output_suffix(vargs);
+
+            std::vector< job_args > jobs;
+            for (auto &job : *expanded) {
+                if (job.empty() || job.front() != "-cc1") {
+                    continue;
+                }
+
+                if (suffix) {
+                    auto out = llvm::find(job, "-o");
+                    if (out != job.end() && std::next(out) != job.end()) {
+                        llvm::SmallString< 128 > path(*std::next(out));
+                        llvm::sys::path::replace_extension(path, *suffix);
+                        *std::next(out) = path.str().str();
+                    }
+                }
+
+                jobs.push_back(std::move(job));
+            }
+
+            return jobs;
+        }
+
+        // Worker thread state reused by all jobs it runs.
+        struct worker {
+            mcontext_t &context() {
+                if (!mctx) {
+                    mctx = std::make_unique< mcontext_t >(mlir::MLIRContext::Threading::DISABLED);
+                }
+                return *mctx;
+            }
+
+            // Called once a translation unit is compiled with the context.
+            void release_context() {
+                if (mctx && should_recycle_context(++compilations)) {
+                    mctx.reset();
+                    compilations = 0;
+                }
+            }
+
+            // A crashed job can leave the context in an inconsistent state, it
+            // is leaked and the next job starts with a fresh one.
+            void discard_context() {
+                llvm::BuryPointer(std::move(mctx));
+                compilations = 0;
+            }
+
+            std::unique_ptr< mcontext_t > mctx;
+            unsigned compilations = 0;
+        };
+
+        struct batch_runner {
+            job_result compile(worker &w, const compile_command &cmd) {
+                job_result result;
+                llvm::raw_string_ostream os(result.diagnostics);
+
+                auto jobs = expand_command(cmd, driver_path, opts.vargs, os);
+                if (!jobs) {
+                    result.status = job_status::failed;
+                    return result;
+                }
+
+                for (const auto &job : *jobs) {
+                    argv_storage ccargs;
+                    for (const auto &arg : llvm::drop_begin(job)) {
+                        ccargs.push_back(arg.c_str());
+                    }
+
+                    int status = 1;
+                    llvm::CrashRecoveryContext crc;
+                    bool completed = crc.RunSafely([&] {
+                        try {
+                            status = cc1_job(opts.vargs, ccargs, tool, main_addr, &w.context(), os);
+                        } catch (std::exception &e) {
+                            os << "error: " << e.what() << '\n';
+                        }
+                    });
+
+                    if (!completed) {
+                        w.discard_context();
+                        result.status = job_status::crashed;
+                        return result;
+                    }
+
+                    if (status != 0) {
+                        result.status = job_status::failed;
+                    }
+                }
+
+                w.release_context();
+                return result;
+            }
+
+            // Reports results in the order of the compilation database as soon
+            // as all preceding translation units are done.
+            void report(std::size_t idx, job_result result) {
+                std::lock_guard< std::mutex > lock(report_mutex);
+                results[idx] = std::move(result);
+                done[idx]    = true;
+
+                for (; reported < results.size() && done[reported]; ++reported) {
+                    const auto &res = results[reported];
+                    llvm::errs() << res.diagnostics;
+
+                    const auto &file = commands[reported].Filename;
+                    switch (res.status) {
+                        case job_status::ok: break;
+                        case job_status::failed:
+                            llvm::errs() << "error: compilation of '" << file << "' failed\n";
+                            ++failed;
+                            break;
+                        case job_status::crashed:
+                            llvm::errs() << "error: compilation of '" << file << "' crashed\n";
+                            ++failed;
+                            break;
+                    }
+
+                    results[reported] = {};
+                }
+            }
+
+            int run() {
+                results.resize(commands.size());
+                done.resize(commands.size(), false);
+
+                llvm::ThreadPool pool(llvm::hardware_concurrency(opts.jobs));
+                std::atomic< std::size_t > next = 0;
+
+                for (unsigned i = 0; i < pool.getThreadCount(); ++i) {
+                    pool.async([&] {
+                        worker w;
+                        for (auto idx = next++; idx < commands.size(); idx = next++) {
+                            report(idx, compile(w, commands[idx]));
+                        }
+                    });
+                }
+
+                pool.wait();
+
+                if (failed) {
+                    llvm::errs() << "error: " << failed << " of " << commands.size()
+                                 << " translation units failed\n";
+                }
+
+                return failed ? 1 : 0;
+            }
+
+            const batch_options &opts;
+            const std::vector< compile_command > &commands;
+            const std::string &driver_path;
+            arg_t tool;
+            void *main_addr;
+
+            std::mutex report_mutex;
+            std::vector< job_result > results;
+            std::vector< bool > done;
+            std::size_t reported = 0;
+            std::size_t failed = 0;
+        };
+
+    } // namespace
+
+    int batch(argv_t args, const std::string &driver_path, void *main_addr) {
+        auto opts = parse_batch_options(args, llvm::errs());
+        if (!opts) {
+            return 1;
+        }
+
+        std::string error;
+        auto db = clang::tooling::JSONCompilationDatabase::loadFromFile(
+            opts->database, error, clang::tooling::JSONCommandLineSyntax::AutoDetect
+        );
+
+        if (!db) {
+            llvm::errs() << "error: " << error << '\n';
+            return 1;
+        }
+
+        llvm::InitializeAllTargets();
+        llvm::InitializeAllTargetMCs();
+        llvm::InitializeAllAsmPrinters();
+        llvm::InitializeAllAsmParsers();
+
+        llvm::CrashRecoveryContext::Enable();
+
+        auto commands = db->getAllCompileCommands();
+        batch_runner runner{ *opts, commands, driver_path, args[0], main_addr };
+        return runner.run();
+    }
+
+} // namespace vast::cc
@@ -54,7 +54,9 @@ static void error_handler(void *user_data, const char *msg, bool get_crash_diag)
 
 namespace vast::cc {
 
-    bool execute_compiler_invocation(compiler_instance *ci, const vast_args &vargs);
+    bool execute_compiler_invocation(
+        compiler_instance *ci, const vast_args &vargs, mcontext_t *mctx = nullptr
+    );
 
     int cc1(const vast_args &vargs, argv_t ccargs, arg_t tool, void *main_addr) {
         // FIXME: ensureSufficientStack
@@ -170,4 +172,51 @@ namespace vast::cc {
         return !success;
     }
 
+    // Runs a cc1 job on one of the worker threads of vast-front. Unlike `cc1`
+    // it leaves the process-wide state (targets, fatal error handler, timers)
+    // untouched and reports diagnostics to `os`. The module is emitted into
+    // `mctx`, so a worker can reuse its context across jobs.
+    int cc1_job(
+        const vast_args &vargs, argv_t ccargs, arg_t tool, void *main_addr,
+        mcontext_t *mctx, llvm::raw_ostream &os
+    ) {
+        auto comp = std::make_unique< compiler_instance >();
+
+        vast::cc::buffered_diagnostics diags(ccargs);
+
+        auto success = compiler_invocation::create_from_args(comp->getInvocation(), diags.engine, ccargs, tool);
+
+        // The driver lets cc1 leak its memory as the process ends right after
+        // it, which is not the case for a worker.
+        comp->getFrontendOpts().DisableFree = false;
+        comp->getCodeGenOpts().DisableFree  = false;
+
+        auto &header_opts = comp->getHeaderSearchOpts();
+        if (header_opts.UseBuiltinIncludes && header_opts.ResourceDir.empty()) {
+            header_opts.ResourceDir = clang_invocation::GetResourcesPath(tool, main_addr);
+        }
+
+        auto printer = new clang::TextDiagnosticPrinter(os, &comp->getDiagnosticOpts());
+        if (comp->createDiagnostics(printer); !comp->hasDiagnostics()) {
+            return 1;
+        }
+
+        diags.buffer.flush(comp->getDiagnostics());
+        if (!success) {
+            comp->getDiagnosticClient().finish();
+            return 1;
+        }
+
+        try {
+            success = execute_compiler_invocation(comp.get(), vargs, mctx);
+        } catch ( ... ) {
+            comp->setSema(nullptr);
+            comp->setASTConsumer(nullptr);
+            comp->clearOutputFiles(true);
+            throw;
+        }
+
+        return !success;
+    }
+
 } // namespace vast::cc
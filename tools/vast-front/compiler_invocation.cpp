@@ -13,43 +13,55 @@ VAST_RELAX_WARNINGS
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Frontend/Action.hpp"
+#include "vast/Frontend/Cache.hpp"
 #include "vast/Frontend/CompilerInstance.hpp"
 
 namespace vast::cc
 {
-    frontend_action_ptr create_frontend_action(compiler_instance &ci, const vast_args &vargs) {
+    frontend_action_ptr create_frontend_action(
+        compiler_instance &ci, const vast_args &vargs, mcontext_t *mctx
+    ) {
         auto &opts = ci.getFrontendOpts();
         auto act   = opts.ProgramAction;
         using namespace clang::frontend;
 
-        if (vargs.has_option(opt::emit_mlir)) {
-            return std::make_unique< vast::cc::emit_mlir_action >(vargs);
+        if (vargs.has_option(opt::emit)) {
+            return std::make_unique< vast::cc::emit_stages_action >(vargs, mctx);
+        }
+
+        if (vargs.has_option(opt::emit_mlir) || vargs.has_option(opt::emit_mlir_bytecode)) {
+            return std::make_unique< vast::cc::emit_mlir_action >(vargs, mctx);
         }
 
         if (vargs.has_option(opt::emit_llvm)) {
-            return std::make_unique< vast::cc::emit_llvm_action >(vargs);
+            return std::make_unique< vast::cc::emit_llvm_action >(vargs, mctx);
         }
 
         if (vargs.has_option(opt::emit_asm)) {
-            return std::make_unique< vast::cc::emit_assembly_action >(vargs);
+            return std::make_unique< vast::cc::emit_assembly_action >(vargs, mctx);
         }
 
         if (vargs.has_option(opt::emit_obj)) {
-            return std::make_unique< vast::cc::emit_obj_action >(vargs);
+            return std::make_unique< vast::cc::emit_obj_action >(vargs, mctx);
         }
 
         switch (act) {
             case ASTDump:  return std::make_unique< clang::ASTDumpAction >();
-            case EmitAssembly: return std::make_unique< vast::cc::emit_assembly_action >(vargs);
-            case EmitLLVM: return std::make_unique< vast::cc::emit_llvm_action >(vargs);
-            case EmitObj: return std::make_unique< vast::cc::emit_obj_action >(vargs);
+            case EmitAssembly: return std::make_unique< vast::cc::emit_assembly_action >(vargs, mctx);
+            case EmitLLVM: return std::make_unique< vast::cc::emit_llvm_action >(vargs, mctx);
+            case EmitObj: return std::make_unique< vast::cc::emit_obj_action >(vargs, mctx);
+            case GeneratePCH: return std::make_unique< clang::GeneratePCHAction >();
+            case GenerateModule: return std::make_unique< clang::GenerateModuleFromModuleMapAction >();
+            case GenerateModuleInterface: return std::make_unique< clang::GenerateModuleInterfaceAction >();
             default: VAST_UNREACHABLE("unsupported frontend action");
         }
 
         VAST_UNIMPLEMENTED_MSG("not implemented frontend action");
     }
 
-    bool execute_compiler_invocation(compiler_instance *ci, const vast_args &vargs) {
+    bool execute_compiler_invocation(
+        compiler_instance *ci, const vast_args &vargs, mcontext_t *mctx
+    ) {
         auto &opts = ci->getFrontendOpts();
 
         // Honor -help.
@@ -80,13 +92,23 @@ namespace vast::cc
         if (ci->getDiagnostics().hasErrorOccurred())
             return false;
 
+        // Reuse the output of an identical earlier compilation.
+        auto cache = result_cache::get(*ci, vargs);
+        if (cache && cache->restore()) {
+            return true;
+        }
+
         // Create and execute the frontend action.
-        auto action = create_frontend_action(*ci, vargs);
+        auto action = create_frontend_action(*ci, vargs, mctx);
         if (!action)
             return false;
 
         bool success = ci->ExecuteAction(*action);
 
+        if (success && cache) {
+            cache->store(*ci);
+        }
+
         if (opts.DisableFree) {
             llvm::BuryPointer(std::move(action));
         }
@@ -22,6 +22,20 @@ VAST_UNRELAX_WARNINGS
 // main frontend method. Lives inside cc1_main.cpp
 namespace vast::cc {
     extern int cc1(const vast_args & vargs, argv_t argv, arg_t tool, void *main_addr);
+
+    extern int cc1_job(
+        const vast_args &vargs, argv_t ccargs, arg_t tool, void *main_addr,
+        mcontext_t *mctx, llvm::raw_ostream &os
+    );
+
+    // batch mode entry point. Lives inside batch.cpp
+    extern int batch(argv_t args, const std::string &driver_path, void *main_addr);
+
+    // compile server entry points. Live inside server.cpp
+    constexpr const char *server_socket_env = "VAST_SERVER";
+
+    extern int serve(string_ref socket_path, const std::string &tool, void *main_addr);
+    extern std::optional< int > compile_on_server(string_ref socket_path, argv_t args);
 } // namespace vast::cc
 
 VAST_RELAX_WARNINGS
@@ -76,6 +90,36 @@ static int execute_cc1_tool(vast::cc::argv_storage_base &cmd_args) {
     return 1;
 }
 
+// Runs a cc1 job of a parallel compilation (-vast-jobs), unlike
+// `execute_cc1_tool` it does not touch global state and reports diagnostics to
+// `os`.
+static int execute_cc1_job(vast::cc::argv_storage_base &cmd_args, llvm::raw_ostream &os) {
+    llvm::BumpPtrAllocator pointer_allocator;
+    llvm::StringSaver saver(pointer_allocator);
+    llvm::cl::ExpandResponseFiles(
+        saver, &llvm::cl::TokenizeGNUCommandLine, cmd_args
+    );
+
+    llvm::StringRef tool = cmd_args[1];
+
+    VAST_RELAX_WARNINGS
+    void *get_executable_path_ptr = (void *) (intptr_t) get_executable_path;
+    VAST_UNRELAX_WARNINGS
+
+    auto [vargs, ccargs] = vast::cc::filter_args(cmd_args);
+
+    if (tool == "-cc1") {
+        auto ccargs_ref = llvm::ArrayRef(ccargs).slice(2);
+        return vast::cc::cc1_job(
+            vargs, ccargs_ref, cmd_args[0], get_executable_path_ptr, nullptr, os
+        );
+    }
+
+    os << "error: unknown integrated tool '" << tool << "'. "
+       << "Valid tools include '-cc1'.\n";
+    return 1;
+}
+
 bool has_canonical_prefixes_option(const vast::cc::argv_storage &args) {
     bool result = true;
 
@@ -114,6 +158,36 @@ void preprocess_vast_arguments(vast::cc::argv_storage &args) {
     }
 }
 
+// Compiles with arguments of a vast-front invocation, either in the frontend
+// (-cc1) or in the compiler driver mode.
+static int compile(vast::cc::argv_storage &cmd_args) {
+    // FIXME: deal with CL mode
+
+    // Check if vast-front is in the frontend mode
+    auto first_arg = llvm::find_if(llvm::drop_begin(cmd_args), [] (auto a) { return a != nullptr; });
+    if (first_arg != cmd_args.end()) {
+        if (std::string_view(cmd_args[1]).starts_with("-cc1")) {
+            // FIXME: deal with EOL sentinels
+            return execute_cc1_tool(cmd_args);
+        }
+    }
+
+    // Handle options that need handling before the real command line parsing in
+    // Driver::BuildCompilation()
+    bool canonical_prefixes = has_canonical_prefixes_option(cmd_args);
+
+    preprocess_vast_arguments(cmd_args);
+
+    // FIXME: handle options that need handling before the real command line parsing
+    std::string driver_path = get_executable_path(cmd_args[0], canonical_prefixes);
+
+    // Not in the frontend mode - continue in the compiler driver mode.
+    vast::cc::driver driver(
+        driver_path, cmd_args, &execute_cc1_tool, canonical_prefixes, &execute_cc1_job
+    );
+    return driver.execute();
+}
+
 int main(int argc, char **argv) try {
     // Initialize variables to call the driver
     llvm::InitLLVM x(argc, argv);
@@ -131,34 +205,41 @@ int main(int argc, char **argv) try {
         return 1;
     }
 
+    // Act as a thin client of a running compile server if there is one
+    if (auto socket = llvm::sys::Process::GetEnv(vast::cc::server_socket_env)) {
+        if (auto status = vast::cc::compile_on_server(*socket, cmd_args)) {
+            return *status;
+        }
+    }
+
     llvm::InitializeAllTargets();
 
-    llvm::BumpPtrAllocator pointer_allocator;
-    llvm::StringSaver saver(pointer_allocator);
+    // Compile all translation units of a compilation database in-process
+    if (cmd_args.size() > 1 && std::string_view(cmd_args[1]) == "--batch") {
+        VAST_RELAX_WARNINGS
+        void *get_executable_path_ptr = (void *) (intptr_t) get_executable_path;
+        VAST_UNRELAX_WARNINGS
 
-    // FIXME: deal with CL mode
-
-    // Check if vast-front is in the frontend mode
-    auto first_arg = llvm::find_if(llvm::drop_begin(cmd_args), [] (auto a) { return a != nullptr; });
-    if (first_arg != cmd_args.end()) {
-        if (std::string_view(cmd_args[1]).starts_with("-cc1")) {
-            // FIXME: deal with EOL sentinels
-            return execute_cc1_tool(cmd_args);
-        }
+        auto driver_path = get_executable_path(cmd_args[0], has_canonical_prefixes_option(cmd_args));
+        return vast::cc::batch(cmd_args, driver_path, get_executable_path_ptr);
     }
 
-    // Handle options that need handling before the real command line parsing in
-    // Driver::BuildCompilation()
-    bool canonical_prefixes = has_canonical_prefixes_option(cmd_args);
+    // Serve compile requests of thin clients until terminated
+    if (cmd_args.size() > 1 && std::string_view(cmd_args[1]) == "--server") {
+        if (cmd_args.size() != 3) {
+            llvm::errs() << "error: --server expects a socket path\n";
+            return 1;
+        }
 
-    preprocess_vast_arguments(cmd_args);
+        VAST_RELAX_WARNINGS
+        void *get_executable_path_ptr = (void *) (intptr_t) get_executable_path;
+        VAST_UNRELAX_WARNINGS
 
-    // FIXME: handle options that need handling before the real command line parsing
-    std::string driver_path = get_executable_path(cmd_args[0], canonical_prefixes);
+        auto tool = get_executable_path(cmd_args[0], /* canonical_prefixes */ true);
+        return vast::cc::serve(cmd_args[2], tool, get_executable_path_ptr);
+    }
 
-    // Not in the frontend mode - continue in the compiler driver mode.
-    vast::cc::driver driver(driver_path, cmd_args, &execute_cc1_tool, canonical_prefixes);
-    return driver.execute();
+    return compile(cmd_args);
 } catch (std::exception &e) {
     llvm::errs() << "error: " << e.what() << '\n';
     std::exit(1);
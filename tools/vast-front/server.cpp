@@ -0,0 +1,595 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+//===----------------------------------------------------------------------===//
+//
+// Compile server of vast-front and its thin client.
+//
+// The server keeps the LLVM targets initialized and mlir contexts with loaded
+// dialects warm across compilations. A client connects to the server over a
+// local UNIX socket and passes it its working directory, arguments and
+// standard error descriptor. The server replies with the exit status.
+//
+// Requests are served concurrently. The server never changes its working
+// directory or standard streams, cc1 jobs get the directory of the client as
+// -working-directory and report diagnostics to its standard error. Requests
+// that depend on the process state in other ways, e.g., write to the standard
+// output or need the linker, are declined and the client compiles locally.
+//
+//===----------------------------------------------------------------------===//
+
+#include "vast/Util/Warnings.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/BuryPointer.h>
+#include <llvm/Support/CrashRecoveryContext.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/ThreadPool.h>
+#include <llvm/Support/raw_ostream.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Frontend/Options.hpp"
+
+#include <csignal>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace vast::cc {
+
+    extern int cc1_job(
+        const vast_args &vargs, argv_t ccargs, arg_t tool, void *main_addr,
+        mcontext_t *mctx, llvm::raw_ostream &os
+    );
+
+    using job_args = std::vector< std::string >;
+
+    // Lives inside batch.cpp
+    extern std::optional< std::vector< job_args > > expand_jobs(
+        argv_t cmd_args, string_ref directory, const std::string &driver_path,
+        llvm::raw_ostream &os
+    );
+
+    // Lives inside batch.cpp
+    extern bool should_recycle_context(unsigned compilations);
+
+    namespace {
+
+        // Status the server replies with to decline a request.
+        constexpr std::uint32_t declined = ~std::uint32_t(0);
+
+        struct socket_t {
+            explicit socket_t(int fd) : fd(fd) {}
+            socket_t(const socket_t &) = delete;
+            socket_t &operator=(const socket_t &) = delete;
+            ~socket_t() { if (fd >= 0) ::close(fd); }
+
+            explicit operator bool() const { return fd >= 0; }
+
+            int fd;
+        };
+
+        std::optional< sockaddr_un > make_address(string_ref path) {
+            sockaddr_un addr = {};
+            if (path.size() >= sizeof(addr.sun_path)) {
+                return std::nullopt;
+            }
+
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, path.data(), path.size());
+            return addr;
+        }
+
+        bool write_all(int fd, const void *data, std::size_t size) {
+            auto bytes = static_cast< const char * >(data);
+            while (size) {
+                auto written = ::write(fd, bytes, size);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if (written <= 0) {
+                    return false;
+                }
+
+                bytes += written;
+                size  -= static_cast< std::size_t >(written);
+            }
+
+            return true;
+        }
+
+        bool read_all(int fd, void *data, std::size_t size) {
+            auto bytes = static_cast< char * >(data);
+            while (size) {
+                auto read = ::read(fd, bytes, size);
+                if (read < 0 && errno == EINTR) {
+                    continue;
+                }
+
+                if (read <= 0) {
+                    return false;
+                }
+
+                bytes += read;
+                size  -= static_cast< std::size_t >(read);
+            }
+
+            return true;
+        }
+
+        bool write_u32(int fd, std::uint32_t value) {
+            return write_all(fd, &value, sizeof(value));
+        }
+
+        std::optional< std::uint32_t > read_u32(int fd) {
+            std::uint32_t value = 0;
+            if (!read_all(fd, &value, sizeof(value))) {
+                return std::nullopt;
+            }
+            return value;
+        }
+
+        bool write_string(int fd, string_ref str) {
+            return write_u32(fd, static_cast< std::uint32_t >(str.size()))
+                && write_all(fd, str.data(), str.size());
+        }
+
+        std::optional< std::string > read_string(int fd) {
+            auto size = read_u32(fd);
+            if (!size) {
+                return std::nullopt;
+            }
+
+            std::string str(*size, '\0');
+            if (!read_all(fd, str.data(), str.size())) {
+                return std::nullopt;
+            }
+            return str;
+        }
+
+        // Passes the standard error of the client to the server.
+        bool send_stream(int sock, int fd) {
+            char byte = 0;
+            iovec iov = { &byte, sizeof(byte) };
+
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+
+            msghdr msg = {};
+            msg.msg_iov        = &iov;
+            msg.msg_iovlen     = 1;
+            msg.msg_control    = control;
+            msg.msg_controllen = sizeof(control);
+
+            auto cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type  = SCM_RIGHTS;
+            cmsg->cmsg_len   = CMSG_LEN(sizeof(int));
+            std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+            return ::sendmsg(sock, &msg, 0) == sizeof(byte);
+        }
+
+        std::optional< int > receive_stream(int sock) {
+            char byte = 0;
+            iovec iov = { &byte, sizeof(byte) };
+
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+
+            msghdr msg = {};
+            msg.msg_iov        = &iov;
+            msg.msg_iovlen     = 1;
+            msg.msg_control    = control;
+            msg.msg_controllen = sizeof(control);
+
+            if (::recvmsg(sock, &msg, 0) != sizeof(byte)) {
+                return std::nullopt;
+            }
+
+            auto cmsg = CMSG_FIRSTHDR(&msg);
+            if (!cmsg || cmsg->cmsg_type != SCM_RIGHTS
+                || cmsg->cmsg_len != CMSG_LEN(sizeof(int))
+            ) {
+                return std::nullopt;
+            }
+
+            int fd = -1;
+            std::memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+            return fd;
+        }
+
+        struct request {
+            std::string cwd;
+            std::vector< std::string > args;
+        };
+
+        bool write_request(int sock, string_ref cwd, argv_t args) {
+            std::vector< string_ref > present;
+            for (auto arg : args) {
+                // skip end-of-line response file markers
+                if (arg) {
+                    present.emplace_back(arg);
+                }
+            }
+
+            if (!write_string(sock, cwd)) {
+                return false;
+            }
+
+            if (!write_u32(sock, static_cast< std::uint32_t >(present.size()))) {
+                return false;
+            }
+
+            for (auto arg : present) {
+                if (!write_string(sock, arg)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        std::optional< request > read_request(int sock) {
+            request req;
+
+            auto cwd = read_string(sock);
+            if (!cwd) {
+                return std::nullopt;
+            }
+            req.cwd = std::move(*cwd);
+
+            auto count = read_u32(sock);
+            if (!count) {
+                return std::nullopt;
+            }
+
+            for (std::uint32_t i = 0; i < *count; ++i) {
+                auto arg = read_string(sock);
+                if (!arg) {
+                    return std::nullopt;
+                }
+                req.args.push_back(std::move(*arg));
+            }
+
+            return req;
+        }
+
+        // Contexts of finished requests ready to be reused by next ones.
+        struct context_pool {
+            struct entry {
+                std::unique_ptr< mcontext_t > mctx;
+                unsigned requests = 0;
+            };
+
+            entry acquire() {
+                std::lock_guard< std::mutex > lock(mutex);
+                if (idle.empty()) {
+                    return { std::make_unique< mcontext_t >(mlir::MLIRContext::Threading::DISABLED) };
+                }
+
+                auto result = std::move(idle.back());
+                idle.pop_back();
+                return result;
+            }
+
+            void release(entry ctx) {
+                if (should_recycle_context(++ctx.requests)) {
+                    return;
+                }
+
+                std::lock_guard< std::mutex > lock(mutex);
+                idle.push_back(std::move(ctx));
+            }
+
+            // A crashed request can leave the context in an inconsistent
+            // state, it is leaked instead of being destroyed or reused.
+            void discard(entry ctx) { llvm::BuryPointer(std::move(ctx.mctx)); }
+
+            std::mutex mutex;
+            std::vector< entry > idle;
+        };
+
+        struct server_state {
+            std::string tool;
+            void *main_addr;
+            context_pool contexts;
+        };
+
+        bool is_immediate_arg(string_ref arg) {
+            return arg == "-###" || arg == "-v" || arg == "--version" || arg == "--help"
+                || arg == "-dumpmachine" || arg == "-dumpversion" || arg.startswith("-print");
+        }
+
+        // Response files and the working directory given by the client are
+        // relative to its process, not to the one of the server.
+        bool is_process_relative_arg(string_ref arg) {
+            return arg.startswith("@") || arg == "-working-directory";
+        }
+
+        // Only jobs writing their output to a file are served, clang opens the
+        // extra outputs relative to the process working directory.
+        bool writes_to_file(const job_args &job) {
+            for (string_ref arg : { "-dependency-file", "-header-include-file" }) {
+                if (llvm::is_contained(job, arg)) {
+                    return false;
+                }
+            }
+
+            auto out = llvm::find(job, "-o");
+            return out != job.end() && std::next(out) != job.end() && *std::next(out) != "-";
+        }
+
+        // Expands the request into cc1 jobs, or returns nothing if the request
+        // has to be compiled by the client.
+        std::optional< std::vector< job_args > > cc1_jobs(
+            const request &req, argv_t ccargs, const server_state &state
+        ) {
+            for (auto arg : ccargs) {
+                if (is_immediate_arg(arg) || is_process_relative_arg(arg)) {
+                    return std::nullopt;
+                }
+            }
+
+            std::vector< job_args > jobs;
+            if (ccargs.size() > 1 && string_ref(ccargs[1]) == "-cc1") {
+                job_args job(std::next(ccargs.begin()), ccargs.end());
+                job.push_back("-working-directory");
+                job.push_back(req.cwd);
+                jobs.push_back(std::move(job));
+            } else {
+                // Driver errors are reported by the local compilation.
+                std::string ignored;
+                llvm::raw_string_ostream os(ignored);
+                auto expanded = expand_jobs(ccargs, req.cwd, state.tool, os);
+                if (!expanded) {
+                    return std::nullopt;
+                }
+                jobs = std::move(*expanded);
+            }
+
+            if (jobs.empty()) {
+                return std::nullopt;
+            }
+
+            for (const auto &job : jobs) {
+                if (job.empty() || job.front() != "-cc1" || !writes_to_file(job)) {
+                    return std::nullopt;
+                }
+            }
+
+            return jobs;
+        }
+
+        int run_jobs(
+            const std::vector< job_args > &jobs, const vast_args &vargs,
+            server_state &state, llvm::raw_ostream &os
+        ) {
+            auto ctx = state.contexts.acquire();
+
+            for (const auto &job : jobs) {
+                argv_storage ccargs;
+                for (const auto &arg : llvm::drop_begin(job)) {
+                    ccargs.push_back(arg.c_str());
+                }
+
+                int status = 1;
+                llvm::CrashRecoveryContext crc;
+                bool completed = crc.RunSafely([&] {
+                    try {
+                        status = cc1_job(
+                            vargs, ccargs, state.tool.c_str(), state.main_addr, ctx.mctx.get(), os
+                        );
+                    } catch (std::exception &e) {
+                        os << "error: " << e.what() << '\n';
+                    }
+                });
+
+                if (!completed) {
+                    state.contexts.discard(std::move(ctx));
+                    return crc.RetCode;
+                }
+
+                if (status != 0) {
+                    state.contexts.release(std::move(ctx));
+                    return status;
+                }
+            }
+
+            state.contexts.release(std::move(ctx));
+            return 0;
+        }
+
+        std::optional< uid_t > peer_uid(int sock) {
+        #if defined(__linux__)
+            ucred cred = {};
+            socklen_t size = sizeof(cred);
+            if (::getsockopt(sock, SOL_SOCKET, SO_PEERCRED, &cred, &size) != 0) {
+                return std::nullopt;
+            }
+            return cred.uid;
+        #else
+            uid_t uid;
+            gid_t gid;
+            if (::getpeereid(sock, &uid, &gid) != 0) {
+                return std::nullopt;
+            }
+            return uid;
+        #endif
+        }
+
+        // Whether a server already answers on the socket.
+        bool is_served(const sockaddr_un &addr) {
+            socket_t sock(::socket(AF_UNIX, SOCK_STREAM, 0));
+            return sock && ::connect(
+                sock.fd, reinterpret_cast< const sockaddr * >(&addr), sizeof(addr)
+            ) == 0;
+        }
+
+        void serve_client(int client, server_state &state) {
+            // Compilations run with the privileges of the server, only its
+            // owner is served.
+            if (peer_uid(client) != ::geteuid()) {
+                return;
+            }
+
+            auto fd = receive_stream(client);
+            if (!fd) {
+                return;
+            }
+
+            socket_t err(*fd);
+
+            auto req = read_request(client);
+            if (!req || req->args.empty()) {
+                return;
+            }
+
+            argv_storage args;
+            for (const auto &arg : req->args) {
+                args.push_back(arg.c_str());
+            }
+
+            auto [vargs, ccargs] = filter_args(args);
+
+            auto jobs = cc1_jobs(*req, ccargs, state);
+            if (!jobs) {
+                write_u32(client, declined);
+                return;
+            }
+
+            int status = 1;
+            {
+                llvm::raw_fd_ostream os(err.fd, /* shouldClose */ false, /* unbuffered */ true);
+                status = run_jobs(*jobs, vargs, state, os);
+            }
+
+            write_u32(client, static_cast< std::uint32_t >(status));
+        }
+
+    } // namespace
+
+    int serve(string_ref socket_path, const std::string &tool, void *main_addr) {
+        auto addr = make_address(socket_path);
+        if (!addr) {
+            llvm::errs() << "error: socket path '" << socket_path << "' is too long\n";
+            return 1;
+        }
+
+        // A client that goes away must not take the server down with it.
+        std::signal(SIGPIPE, SIG_IGN);
+
+        socket_t sock(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if (!sock) {
+            llvm::errs() << "error: unable to create socket\n";
+            return 1;
+        }
+
+        // Remove a socket left behind by a previous server, unless it is
+        // still running.
+        llvm::sys::fs::file_status status;
+        if (!llvm::sys::fs::status(socket_path, status)
+            && status.type() == llvm::sys::fs::file_type::socket_file
+        ) {
+            if (is_served(*addr)) {
+                llvm::errs() << "error: a server is already listening on '" << socket_path << "'\n";
+                return 1;
+            }
+
+            llvm::sys::fs::remove(socket_path);
+        }
+
+        // The socket is accessible only to its owner from the start.
+        auto mask = ::umask(0077);
+        auto bound = ::bind(sock.fd, reinterpret_cast< sockaddr * >(&*addr), sizeof(*addr)) == 0;
+        ::umask(mask);
+
+        if (!bound || ::listen(sock.fd, SOMAXCONN) != 0) {
+            llvm::errs() << "error: unable to listen on '" << socket_path << "': "
+                         << std::strerror(errno) << '\n';
+            return 1;
+        }
+
+        // Requests run concurrently, targets are initialized upfront.
+        llvm::InitializeAllTargetInfos();
+        llvm::InitializeAllTargets();
+        llvm::InitializeAllTargetMCs();
+        llvm::InitializeAllAsmPrinters();
+
+        llvm::CrashRecoveryContext::Enable();
+
+        server_state state{ .tool = tool, .main_addr = main_addr };
+        llvm::ThreadPool pool(llvm::hardware_concurrency());
+
+        llvm::errs() << "vast-front: listening on " << socket_path << '\n';
+
+        while (true) {
+            int client = ::accept(sock.fd, nullptr, nullptr);
+            if (client < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+
+                llvm::errs() << "error: accept failed: " << std::strerror(errno) << '\n';
+                pool.wait();
+                return 1;
+            }
+
+            pool.async([client, &state] {
+                socket_t guard(client);
+                serve_client(guard.fd, state);
+            });
+        }
+    }
+
+    std::optional< int > compile_on_server(string_ref socket_path, argv_t args) {
+        auto addr = make_address(socket_path);
+        if (!addr) {
+            return std::nullopt;
+        }
+
+        socket_t sock(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if (!sock) {
+            return std::nullopt;
+        }
+
+        // No server is running, compile locally.
+        if (::connect(sock.fd, reinterpret_cast< sockaddr * >(&*addr), sizeof(*addr)) != 0) {
+            return std::nullopt;
+        }
+
+        llvm::SmallString< 128 > cwd;
+        if (llvm::sys::fs::current_path(cwd)) {
+            return std::nullopt;
+        }
+
+        std::signal(SIGPIPE, SIG_IGN);
+
+        if (!send_stream(sock.fd, STDERR_FILENO) || !write_request(sock.fd, cwd, args)) {
+            return std::nullopt;
+        }
+
+        // Unless declined, the request is accepted at this point, the server
+        // may have already written outputs, so there is no falling back to a
+        // local compilation.
+        auto status = read_u32(sock.fd);
+        if (!status) {
+            llvm::errs() << "error: lost connection to the vast-front server\n";
+            return 1;
+        }
+
+        if (*status == declined) {
+            return std::nullopt;
+        }
+
+        return static_cast< int >(*status);
+    }
+
+} // namespace vast::cc
@@ -0,0 +1,230 @@
+// Copyright (c) 2024-present, Trail of Bits, Inc.
+
+#include "vast/query/index.hpp"
+
+VAST_RELAX_WARNINGS
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringMap.h>
+#include <mlir/IR/SymbolTable.h>
+VAST_UNRELAX_WARNINGS
+
+#include "vast/Dialect/HighLevel/HighLevelOps.hpp"
+#include "vast/Util/Symbols.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace vast::query::index
+{
+    namespace
+    {
+        struct string_table {
+            string_record add(string_ref str) {
+                auto [it, inserted] = offsets.try_emplace(str, data.size());
+                if (inserted) {
+                    data.append(str);
+                }
+
+                string_record rec;
+                rec.offset = it->second;
+                rec.size   = static_cast< std::uint32_t >(str.size());
+                return rec;
+            }
+
+            llvm::StringMap< std::uint32_t > offsets;
+            std::string data;
+        };
+
+        struct position {
+            std::uint32_t offset;
+            std::uint32_t end;
+        };
+
+        using positions_t = llvm::DenseMap< operation, position >;
+
+        // Assigns pre-order positions to all operations nested in `op`.
+        std::uint32_t number(operation op, positions_t &positions, std::uint32_t next) {
+            auto offset = next++;
+            for (auto &region : op->getRegions()) {
+                for (auto &block : region) {
+                    for (auto &child : block) {
+                        next = number(&child, positions, next);
+                    }
+                }
+            }
+
+            positions[op] = { offset, next - 1 };
+            return next;
+        }
+
+        std::uint32_t flags(operation op) {
+            std::uint32_t result = none_flag;
+
+            if (mlir::isa< hl::FuncOp >(op)) {
+                result |= function_flag;
+            }
+
+            if (mlir::isa< hl::TypeDefOp, hl::TypeDeclOp >(op)) {
+                result |= type_flag;
+            }
+
+            if (mlir::isa< hl::StructDeclOp >(op)) {
+                result |= record_flag;
+            }
+
+            if (mlir::isa< hl::VarDeclOp >(op)) {
+                result |= var_flag;
+                if (mlir::isa< vast_module, hl::TranslationUnitOp >(op->getParentOp())) {
+                    result |= global_flag;
+                }
+            }
+
+            if (mlir::isa< util::mlir_symbol_interface >(op)) {
+                result |= mlir_symbol_flag;
+                if (op->getParentOp()->hasTrait< mlir::OpTrait::SymbolTable >()) {
+                    result |= table_symbol_flag;
+                }
+            }
+
+            return result;
+        }
+
+        std::string print(operation op) {
+            std::string buff;
+            llvm::raw_string_ostream ss(buff);
+            op->print(ss);
+            return ss.str();
+        }
+
+        template< typename record_t >
+        void write_records(llvm::raw_ostream &os, const std::vector< record_t > &records) {
+            os.write(reinterpret_cast< const char * >(records.data()), records.size() * sizeof(record_t));
+        }
+
+    } // namespace
+
+    void write(vast_module mod, llvm::raw_ostream &os) {
+        positions_t positions;
+        number(mod, positions, 0);
+
+        // Users of mlir symbols are collected in a single walk of the module.
+        mlir::SymbolTableCollection tables;
+        mlir::SymbolUserMap mlir_users(tables, mod);
+
+        string_table strings;
+        std::vector< symbol_record > symbols;
+        std::vector< user_record > users;
+
+        util::symbols(mod, [&] (auto symbol) {
+            operation op = symbol.getOperation();
+
+            symbol_record rec;
+            rec.kind     = strings.add(op->getName().getStringRef());
+            rec.name     = strings.add(util::symbol_name(symbol));
+            rec.location = strings.add(util::show_location(symbol));
+            rec.offset   = positions[op].offset;
+            rec.end      = positions[op].end;
+            rec.flags    = flags(op);
+
+            auto add_user = [&] (operation user) {
+                user_record urec;
+                urec.text     = strings.add(print(user));
+                urec.location = strings.add(util::show_location(*user));
+                urec.offset   = positions[user].offset;
+                users.push_back(urec);
+            };
+
+            rec.users_begin = static_cast< std::uint32_t >(users.size());
+            if (mlir::isa< util::vast_symbol_interface >(op)) {
+                for (auto user : op->getUsers()) {
+                    add_user(user);
+                }
+            } else {
+                for (auto user : mlir_users.getUsers(op)) {
+                    add_user(user);
+                }
+            }
+            rec.users_count = static_cast< std::uint32_t >(users.size()) - rec.users_begin;
+
+            symbols.push_back(rec);
+        });
+
+        header head;
+        std::memcpy(head.magic, magic, sizeof(magic));
+        head.version       = version;
+        head.symbols_count = static_cast< std::uint32_t >(symbols.size());
+        head.users_count   = static_cast< std::uint32_t >(users.size());
+        head.strings_size  = static_cast< std::uint32_t >(strings.data.size());
+
+        os.write(reinterpret_cast< const char * >(&head), sizeof(head));
+        write_records(os, symbols);
+        write_records(os, users);
+        os << strings.data;
+    }
+
+    bool is_index(const llvm::MemoryBuffer &buffer) {
+        return buffer.getBufferSize() >= sizeof(magic)
+            && std::memcmp(buffer.getBufferStart(), magic, sizeof(magic)) == 0;
+    }
+
+    std::optional< view > view::get(std::unique_ptr< llvm::MemoryBuffer > buffer) {
+        if (!is_index(*buffer) || buffer->getBufferSize() < sizeof(header)) {
+            return std::nullopt;
+        }
+
+        auto data = buffer->getBufferStart();
+        const auto &head = *reinterpret_cast< const header * >(data);
+        if (head.version != version) {
+            return std::nullopt;
+        }
+
+        std::size_t symbols_size = head.symbols_count * sizeof(symbol_record);
+        std::size_t users_size   = head.users_count * sizeof(user_record);
+        std::size_t total = sizeof(header) + symbols_size + users_size + head.strings_size;
+        if (buffer->getBufferSize() != total) {
+            return std::nullopt;
+        }
+
+        auto symbols_start = data + sizeof(header);
+        auto users_start   = symbols_start + symbols_size;
+        auto strings_start = users_start + users_size;
+
+        // Records refer to the other arrays by offsets read from the file,
+        // a corrupt index must not make the view read out of the buffer.
+        auto valid_string = [&] (const string_record &rec) {
+            return std::uint64_t(rec.offset) + rec.size <= head.strings_size;
+        };
+
+        auto symbols = std::span(
+            reinterpret_cast< const symbol_record * >(symbols_start), head.symbols_count
+        );
+
+        for (const auto &symbol : symbols) {
+            if (!valid_string(symbol.kind) || !valid_string(symbol.name) || !valid_string(symbol.location)) {
+                return std::nullopt;
+            }
+
+            if (std::uint64_t(symbol.users_begin) + symbol.users_count > head.users_count) {
+                return std::nullopt;
+            }
+        }
+
+        auto users = std::span(
+            reinterpret_cast< const user_record * >(users_start), head.users_count
+        );
+
+        for (const auto &user : users) {
+            if (!valid_string(user.text) || !valid_string(user.location)) {
+                return std::nullopt;
+            }
+        }
+
+        view result;
+        result._symbols = symbols;
+        result._users   = users;
+        result._strings = string_ref(strings_start, head.strings_size);
+        result._buffer  = std::move(buffer);
+        return result;
+    }
+
+} // namespace vast::query::index
@@ -12,9 +12,15 @@ VAST_RELAX_WARNINGS
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Tools/mlir-opt/MlirOptMain.h"
 #include "mlir/Parser/Parser.h"
+#include "mlir/IR/SymbolTable.h"
 
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/LineIterator.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 VAST_UNRELAX_WARNINGS
 
@@ -24,8 +30,10 @@ VAST_UNRELAX_WARNINGS
 #include "vast/Dialect/HighLevel/HighLevelOps.hpp"
 #include "vast/Dialect/HighLevel/HighLevelTypes.hpp"
 #include "vast/Dialect/HighLevel/Passes.hpp"
+#include "vast/Util/Bytecode.hpp"
 #include "vast/Util/Common.hpp"
 #include "vast/Util/Symbols.hpp"
+#include "vast/query/index.hpp"
 
 using memory_buffer  = std::unique_ptr< llvm::MemoryBuffer >;
 
@@ -42,10 +50,21 @@ namespace vast::cl
     cl::OptionCategory queries("Vast Queries Options");
 
     struct vast_query_options {
-        cl::opt< std::string > input_file{
-            cl::desc("<input file>"),
+        cl::list< std::string > input_files{
+            cl::desc("<input files>"),
             cl::Positional,
-            cl::init("-"),
+            cl::ZeroOrMore,
+            cl::cat(generic)
+        };
+        cl::opt< std::string > input_list{ "input-list",
+            cl::desc("Read input files from a file, one per line"),
+            cl::value_desc("filename"),
+            cl::init(""),
+            cl::cat(generic)
+        };
+        cl::opt< unsigned > jobs{ "j",
+            cl::desc("Number of modules queried in parallel (0 uses all cores)"),
+            cl::init(0),
             cl::cat(generic)
         };
         cl::opt< show_symbol_type > show_symbols{ "show-symbols",
@@ -73,6 +92,23 @@ namespace vast::cl
             cl::init(""),
             cl::cat(queries)
         };
+        cl::opt< bool > build_index{ "index",
+            cl::desc("Build on-disk symbol index of the input module"),
+            cl::init(false),
+            cl::cat(generic)
+        };
+        cl::opt< std::string > output_file{ "o",
+            cl::desc("Output index file (defaults to <input file>.idx)"),
+            cl::value_desc("filename"),
+            cl::init(""),
+            cl::cat(generic)
+        };
+        cl::opt< std::string > batch_file{ "batch",
+            cl::desc("Answer queries listed in a file ('-' for stdin) as JSON lines"),
+            cl::value_desc("filename"),
+            cl::init(""),
+            cl::cat(generic)
+        };
     };
     // clang-format on
 
@@ -83,11 +119,215 @@ namespace vast::cl
 
 namespace vast::query
 {
-    bool show_symbols() { return cl::options->show_symbols != cl::show_symbol_type::none; }
+    //
+    // A single query given either by the command line options or by a line
+    // of a batch.
+    //
+    struct query_t {
+        cl::show_symbol_type show_symbols = cl::show_symbol_type::none;
+        std::string symbol_users;
+        std::string scope;
+
+        bool shows_symbols() const { return show_symbols != cl::show_symbol_type::none; }
+
+        bool shows_users() const { return !symbol_users.empty(); }
+
+        bool constrained_scope() const { return !scope.empty(); }
+
+        // Functions and globals are answered without function bodies.
+        bool needs_bodies() const {
+            switch (show_symbols) {
+                case cl::show_symbol_type::function:
+                case cl::show_symbol_type::global: return false;
+                case cl::show_symbol_type::type:
+                case cl::show_symbol_type::record:
+                case cl::show_symbol_type::var:
+                case cl::show_symbol_type::all: return true;
+                case cl::show_symbol_type::none: return shows_users();
+            }
+
+            VAST_UNREACHABLE("unknown symbol kind");
+        }
+    };
+
+    query_t options_query() {
+        return {
+            cl::options->show_symbols.getValue(),
+            cl::options->show_symbol_users.getValue(),
+            cl::options->scope_name.getValue()
+        };
+    }
+
+    std::optional< cl::show_symbol_type > parse_symbol_type(string_ref kind) {
+        return llvm::StringSwitch< std::optional< cl::show_symbol_type > >(kind)
+            .Case("functions", cl::show_symbol_type::function)
+            .Case("types", cl::show_symbol_type::type)
+            .Case("records", cl::show_symbol_type::record)
+            .Case("vars", cl::show_symbol_type::var)
+            .Case("globs", cl::show_symbol_type::global)
+            .Case("all", cl::show_symbol_type::all)
+            .Default(std::nullopt);
+    }
+
+    llvm::Error set_query_option(query_t &query, string_ref key, string_ref value) {
+        if (key == "show-symbols") {
+            if (auto kind = parse_symbol_type(value)) {
+                query.show_symbols = *kind;
+                return llvm::Error::success();
+            }
+
+            return llvm::createStringError(
+                llvm::inconvertibleErrorCode(), "unknown symbol kind '%s'", value.str().c_str()
+            );
+        }
+
+        if (key == "symbol-users") {
+            query.symbol_users = value.str();
+            return llvm::Error::success();
+        }
+
+        if (key == "scope") {
+            query.scope = value.str();
+            return llvm::Error::success();
+        }
+
+        return llvm::createStringError(
+            llvm::inconvertibleErrorCode(), "unknown query option '%s'", key.str().c_str()
+        );
+    }
 
-    bool show_symbol_users() { return !cl::options->show_symbol_users.empty(); }
+    // Parses a query either from a JSON object, e.g.:
+    //   {"show-symbols": "vars", "scope": "main"}
+    // or from options in the command line syntax, e.g.:
+    //   --show-symbols=vars --scope=main
+    llvm::Expected< query_t > parse_query(string_ref line) {
+        query_t query;
+
+        if (line.trim().starts_with("{")) {
+            auto json = llvm::json::parse(line);
+            if (!json) {
+                return json.takeError();
+            }
+
+            auto obj = json->getAsObject();
+            if (!obj) {
+                return llvm::createStringError(
+                    llvm::inconvertibleErrorCode(), "query is not a JSON object"
+                );
+            }
+
+            for (const auto &[key, value] : *obj) {
+                auto str = value.getAsString();
+                if (!str) {
+                    return llvm::createStringError(
+                        llvm::inconvertibleErrorCode(), "expected string value of '%s'",
+                        key.str().c_str()
+                    );
+                }
+
+                if (auto err = set_query_option(query, key, *str)) {
+                    return std::move(err);
+                }
+            }
+
+            return query;
+        }
+
+        llvm::SmallVector< string_ref > args;
+        line.split(args, ' ', -1, /* KeepEmpty */ false);
+        for (auto arg : args) {
+            arg = arg.trim().ltrim('-');
+            auto [key, value] = arg.split('=');
+            if (auto err = set_query_option(query, key, value)) {
+                return std::move(err);
+            }
+        }
+
+        return query;
+    }
+
+    //
+    // Writes query results either as plain text or as JSON lines tagged
+    // with the index of the query in the batch. When many modules are
+    // queried, results are also tagged with the name of their module.
+    //
+    struct printer_t {
+        void symbol(string_ref kind, string_ref name, string_ref location) const {
+            if (!json) {
+                tag() << kind << " : " << name << " " << location << "\n";
+                return;
+            }
+
+            emit([&] (llvm::json::OStream &os) {
+                os.attribute("symbol", name);
+                os.attribute("kind", kind);
+                os.attribute("location", strip(location));
+            });
+        }
+
+        void user(string_ref text, string_ref location) const {
+            if (!json) {
+                tag() << text << location << "\n";
+                return;
+            }
+
+            emit([&] (llvm::json::OStream &os) {
+                os.attribute("user", text);
+                os.attribute("location", strip(location));
+            });
+        }
+
+        void error(string_ref message) const {
+            if (!json) {
+                diagnostic(message);
+                return;
+            }
+
+            emit([&] (llvm::json::OStream &os) { os.attribute("error", message); });
+        }
+
+        // Reports an error of the tool itself, e.g., an unreadable input.
+        void diagnostic(string_ref message) const {
+            *es << "error: ";
+            if (!module.empty()) {
+                *es << module << ": ";
+            }
+            *es << message << "\n";
+        }
 
-    bool constrained_scope() { return !cl::options->scope_name.empty(); }
+        bool json = false;
+        std::size_t query_id = 0;
+        std::string module;
+
+        llvm::raw_ostream *os = &llvm::outs();
+        llvm::raw_ostream *es = &llvm::errs();
+
+      private:
+        llvm::raw_ostream &tag() const {
+            if (!module.empty()) {
+                *os << module << " : ";
+            }
+            return *os;
+        }
+
+        void emit(auto &&attributes) const {
+            llvm::json::OStream json_os(*os);
+            json_os.object([&] {
+                if (!module.empty()) {
+                    json_os.attribute("module", module);
+                }
+                json_os.attribute("query", static_cast< std::int64_t >(query_id));
+                attributes(json_os);
+            });
+            *os << "\n";
+        }
+
+        // Locations are shown with a leading separator in the text output.
+        static string_ref strip(string_ref location) {
+            location.consume_front(" : ");
+            return location;
+        }
+    };
 
     template< typename... Ts >
     auto is_one_of() {
@@ -102,75 +342,407 @@ namespace vast::query
         };
     }
 
-    void show_value(auto value) {
-        llvm::outs() << util::show_symbol_value(value) << "\n";
+    bool has_kind(mlir::Operation *op, cl::show_symbol_type kind) {
+        switch (kind) {
+            case cl::show_symbol_type::all: return true;
+            case cl::show_symbol_type::type:
+                return is_one_of< hl::TypeDefOp, hl::TypeDeclOp >()(op);
+            case cl::show_symbol_type::record: return is_one_of< hl::StructDeclOp >()(op);
+            case cl::show_symbol_type::var: return is_one_of< hl::VarDeclOp >()(op);
+            case cl::show_symbol_type::global: return is_global< hl::VarDeclOp >()(op);
+            case cl::show_symbol_type::function: return is_one_of< hl::FuncOp >()(op);
+            case cl::show_symbol_type::none: return false;
+        }
+
+        VAST_UNREACHABLE("unknown symbol kind");
     }
 
-    logical_result do_show_symbols(auto scope) {
-        auto &show_kind = cl::options->show_symbols;
+    //
+    // Index of symbols by name and of their users, built once after parsing,
+    // so that user queries do not need to walk the module.
+    //
+    struct symbol_index {
+        symbol_index(vast_module mod, mlir::SymbolTableCollection &tables)
+            : mlir_users(tables, mod)
+        {
+            util::symbols(mod, [&] (auto symbol) {
+                by_name[util::symbol_name(symbol)].push_back(symbol.getOperation());
+            });
+        }
 
-        auto show_if = [=](auto symbol, auto pred) {
-            if (pred(symbol))
-                show_value(symbol);
-        };
+        void yield_users(string_ref name, mlir::Operation *scope, auto &&yield) const {
+            auto it = by_name.find(name);
+            if (it == by_name.end()) {
+                return;
+            }
+
+            for (auto symbol : it->second) {
+                if (!scope->isAncestor(symbol)) {
+                    continue;
+                }
+
+                if (mlir::isa< util::vast_symbol_interface >(symbol)) {
+                    for (auto user : symbol->getUsers()) {
+                        yield(user);
+                    }
+                } else {
+                    // mlir symbol uses are resolved in the queried scope
+                    for (auto user : mlir_users.getUsers(symbol)) {
+                        if (scope->isAncestor(user)) {
+                            yield(user);
+                        }
+                    }
+                }
+            }
+        }
+
+        mlir::SymbolUserMap mlir_users;
+        llvm::StringMap< llvm::SmallVector< mlir::Operation *, 1 > > by_name;
+    };
+
+    std::string unknown_scope(string_ref name) {
+        return ("unknown scope '" + name + "'").str();
+    }
+
+    //
+    // Queries answered from a parsed module. A module read from bytecode
+    // loads only the function bodies needed by the queried scope.
+    //
+    struct module_source {
+        explicit module_source(vast_module mod, util::lazy_module *lazy = nullptr)
+            : mod(mod), lazy(lazy)
+        {}
+
+        logical_result run(const query_t &query, const printer_t &out) {
+            auto process_scope = [&] (mlir::Operation *scope) {
+                if (query.needs_bodies() && failed(load(scope))) {
+                    out.error("cannot load bodies of the queried scope");
+                    return mlir::failure();
+                }
+
+                if (query.shows_symbols()) {
+                    return show_symbols(query.show_symbols, scope, out);
+                }
 
-        auto filter_kind = [=](cl::show_symbol_type kind) {
-            return [=](auto symbol) {
-                switch (kind) {
-                    case cl::show_symbol_type::all: show_value(symbol); break;
-                    case cl::show_symbol_type::type:
-                        show_if(symbol, is_one_of< hl::TypeDefOp, hl::TypeDeclOp >());
-                        break;
-                    case cl::show_symbol_type::record:
-                        show_if(symbol, is_one_of< hl::StructDeclOp >());
-                        break;
-                    case cl::show_symbol_type::var:
-                        show_if(symbol, is_one_of< hl::VarDeclOp >());
-                        break;
-                    case cl::show_symbol_type::global:
-                        show_if(symbol, is_global< hl::VarDeclOp >());
-                        break;
-                    case cl::show_symbol_type::function:
-                        show_if(symbol, is_one_of< hl::FuncOp >());
-                        break;
-                    case cl::show_symbol_type::none: break;
+                if (query.shows_users()) {
+                    return show_users(query.symbol_users, scope, out);
                 }
+
+                return mlir::success();
             };
-        };
 
-        util::symbols(scope, filter_kind(show_kind));
-        return mlir::success();
+            if (!query.constrained_scope()) {
+                return process_scope(mod);
+            }
+
+            auto result = mlir::success();
+            bool found = false;
+            auto name = mlir::StringAttr::get(mod->getContext(), query.scope);
+            util::symbol_tables(mod, [&](mlir::Operation *op) {
+                // Most of the tables do not contain the scope.
+                auto scope = tables.lookupSymbolIn(op, name);
+                if (!scope) {
+                    return;
+                }
+
+                found = true;
+                if (failed(process_scope(scope))) {
+                    result = mlir::failure();
+                }
+            });
+
+            if (!found) {
+                out.error(unknown_scope(query.scope));
+                return mlir::failure();
+            }
+
+            return result;
+        }
+
+        logical_result show_symbols(
+            cl::show_symbol_type kind, mlir::Operation *scope, const printer_t &out
+        ) {
+            util::symbols(scope, [&] (auto symbol) {
+                if (has_kind(symbol, kind)) {
+                    out.symbol(
+                        symbol->getName().getStringRef(), util::symbol_name(symbol),
+                        util::show_location(symbol)
+                    );
+                }
+            });
+
+            return mlir::success();
+        }
+
+        logical_result show_users(string_ref name, mlir::Operation *scope, const printer_t &out) {
+            index().yield_users(name, scope, [&] (mlir::Operation *user) {
+                std::string text;
+                llvm::raw_string_ostream os(text);
+                user->print(os);
+                out.user(os.str(), util::show_location(*user));
+            });
+
+            return mlir::success();
+        }
+
+        const symbol_index &index() {
+            if (!symbols) {
+                symbols.emplace(mod, tables);
+            }
+
+            return *symbols;
+        }
+
+        logical_result load(mlir::Operation *scope) {
+            if (!lazy) {
+                return mlir::success();
+            }
+
+            auto pending = lazy->pending();
+            if (failed(lazy->materialize(scope))) {
+                return mlir::failure();
+            }
+
+            // newly loaded bodies may contain users not seen by the index
+            if (lazy->pending() != pending) {
+                symbols.reset();
+            }
+
+            return mlir::success();
+        }
+
+        vast_module mod;
+        util::lazy_module *lazy;
+        mlir::SymbolTableCollection tables;
+        std::optional< symbol_index > symbols;
+    };
+
+    //
+    // Queries answered from the on-disk index
+    //
+    bool has_kind(std::uint32_t flags, cl::show_symbol_type kind) {
+        switch (kind) {
+            case cl::show_symbol_type::all: return true;
+            case cl::show_symbol_type::type: return flags & index::type_flag;
+            case cl::show_symbol_type::record: return flags & index::record_flag;
+            case cl::show_symbol_type::var: return flags & index::var_flag;
+            case cl::show_symbol_type::global: return flags & index::global_flag;
+            case cl::show_symbol_type::function: return flags & index::function_flag;
+            case cl::show_symbol_type::none: return false;
+        }
+
+        VAST_UNREACHABLE("unknown symbol kind");
     }
 
-    logical_result do_show_users(auto scope) {
-        auto &name = cl::options->show_symbol_users;
-        util::yield_users(name.getValue(), scope, [](auto user) {
-            user->print(llvm::outs());
-            llvm::outs() << util::show_location(*user) << "\n";
-        });
+    struct index_scope {
+        std::uint32_t offset;
+        std::uint32_t end;
 
-        return mlir::success();
+        bool contains(std::uint32_t pos) const { return offset <= pos && pos <= end; }
+    };
+
+    struct index_source {
+        explicit index_source(index::view idx) : idx(std::move(idx)) {}
+
+        logical_result run(const query_t &query, const printer_t &out) const {
+            auto process_scope = [&] (index_scope scope) {
+                if (query.shows_symbols()) {
+                    return show_symbols(query.show_symbols, scope, out);
+                }
+
+                if (query.shows_users()) {
+                    return show_users(query.symbol_users, scope, out);
+                }
+
+                return mlir::success();
+            };
+
+            if (!query.constrained_scope()) {
+                return process_scope({ 0, std::numeric_limits< std::uint32_t >::max() });
+            }
+
+            bool found = false;
+            for (const auto &symbol : idx.symbols()) {
+                if (symbol.flags & index::table_symbol_flag
+                    && idx.str(symbol.name) == query.scope)
+                {
+                    found = true;
+                    if (failed(process_scope({ symbol.offset, symbol.end }))) {
+                        return mlir::failure();
+                    }
+                }
+            }
+
+            if (!found) {
+                out.error(unknown_scope(query.scope));
+                return mlir::failure();
+            }
+
+            return mlir::success();
+        }
+
+        logical_result show_symbols(
+            cl::show_symbol_type kind, index_scope scope, const printer_t &out
+        ) const {
+            for (const auto &symbol : idx.symbols()) {
+                if (scope.contains(symbol.offset) && has_kind(symbol.flags, kind)) {
+                    out.symbol(idx.str(symbol.kind), idx.str(symbol.name), idx.str(symbol.location));
+                }
+            }
+
+            return mlir::success();
+        }
+
+        logical_result show_users(string_ref name, index_scope scope, const printer_t &out) const {
+            for (const auto &symbol : idx.symbols()) {
+                if (!scope.contains(symbol.offset) || idx.str(symbol.name) != name) {
+                    continue;
+                }
+
+                // mlir symbol uses are resolved in the queried scope
+                bool scoped = symbol.flags & index::mlir_symbol_flag;
+                for (const auto &user : idx.users(symbol)) {
+                    if (!scoped || scope.contains(user.offset)) {
+                        out.user(idx.str(user.text), idx.str(user.location));
+                    }
+                }
+            }
+
+            return mlir::success();
+        }
+
+        index::view idx;
+    };
+
+    // Queries of a batch, read once and answered for each input module.
+    using batch_t = std::vector< std::string >;
+
+    std::optional< batch_t > read_lines(string_ref file, const printer_t &out) {
+        std::string err;
+        auto buffer = mlir::openInputFile(file, &err);
+        if (!buffer) {
+            out.diagnostic(err);
+            return std::nullopt;
+        }
+
+        batch_t lines;
+        for (llvm::line_iterator line(*buffer, /* SkipBlanks */ true, '#'); !line.is_at_end(); ++line) {
+            lines.push_back(line->trim().str());
+        }
+
+        return lines;
+    }
+
+    //
+    // Answers all queries of the batch, one per line, against a single source.
+    //
+    logical_result run_batch(auto &source, const batch_t &batch, printer_t out) {
+        auto result = mlir::success();
+
+        out.json = true;
+        for (const auto &line : batch) {
+            if (auto query = parse_query(line)) {
+                // sources report their own errors
+                if (failed(source.run(*query, out))) {
+                    result = mlir::failure();
+                }
+            } else {
+                out.error(llvm::toString(query.takeError()));
+                result = mlir::failure();
+            }
+
+            // stream results as soon as the query is answered
+            out.os->flush();
+            ++out.query_id;
+        }
+
+        return result;
+    }
+
+    logical_result answer(auto &source, const std::optional< batch_t > &batch, const printer_t &out) {
+        if (batch) {
+            return run_batch(source, *batch, out);
+        }
+
+        return source.run(options_query(), out);
     }
+
 } // namespace vast::query
 
 namespace vast
 {
-    logical_result get_scope_operation(auto parent, std::string_view scope_name, auto yield) {
-        auto result =mlir::success();
-        util::symbol_tables(parent, [&](mlir::Operation *op) {
-            if (failed(yield(mlir::SymbolTable::lookupSymbolIn(op, scope_name)))) {
-                result = mlir::failure();
+    using query::batch_t;
+    using query::printer_t;
+
+    logical_result do_index_query(
+        memory_buffer buffer, const std::optional< batch_t > &batch, const printer_t &out
+    ) {
+        auto idx = query::index::view::get(std::move(buffer));
+        if (!idx) {
+            out.diagnostic("malformed symbol index");
+            return mlir::failure();
+        }
+
+        query::index_source source(std::move(*idx));
+        return query::answer(source, batch, out);
+    }
+
+    logical_result write_index(vast_module mod, string_ref input, const printer_t &out) {
+        std::string output = cl::options->output_file;
+        if (output.empty()) {
+            output = input.str() + ".idx";
+        }
+
+        std::string err;
+        auto file = mlir::openOutputFile(output, &err);
+        if (!file) {
+            out.diagnostic(err);
+            return mlir::failure();
+        }
+
+        query::index::write(mod, file->os());
+        file->keep();
+        return mlir::success();
+    }
+
+    logical_result do_bytecode_query(
+        mcontext_t &ctx, memory_buffer buffer, string_ref input,
+        const std::optional< batch_t > &batch, const printer_t &out
+    ) {
+        auto lazy = util::lazy_module::read(std::move(buffer), &ctx);
+        if (!lazy) {
+            out.diagnostic("cannot read module");
+            return mlir::failure();
+        }
+
+        if (cl::options->build_index) {
+            if (failed(lazy->materialize_all())) {
+                return mlir::failure();
             }
-        });
 
-        return result;
+            return write_index(lazy->get(), input, out);
+        }
+
+        query::module_source source(lazy->get(), lazy.get());
+        return query::answer(source, batch, out);
     }
 
-    logical_result do_query(mcontext_t &ctx, memory_buffer buffer) {
+    logical_result do_query(
+        mcontext_t &ctx, memory_buffer buffer, string_ref input,
+        const std::optional< batch_t > &batch, const printer_t &out
+    ) {
+        if (query::index::is_index(*buffer)) {
+            return do_index_query(std::move(buffer), batch, out);
+        }
+
         llvm::SourceMgr source_mgr;
-        source_mgr.AddNewSourceBuffer(std::move(buffer), llvm::SMLoc());
+        mlir::SourceMgrDiagnosticHandler manager_handler(source_mgr, &ctx, *out.es);
+
+        if (util::is_bytecode(*buffer)) {
+            return do_bytecode_query(ctx, std::move(buffer), input, batch, out);
+        }
 
-        mlir::SourceMgrDiagnosticHandler manager_handler(source_mgr, &ctx);
+        source_mgr.AddNewSourceBuffer(std::move(buffer), llvm::SMLoc());
 
         // Disable multi-threading when parsing the input file. This removes the
         // unnecessary/costly context synchronization when parsing.
@@ -180,36 +752,134 @@ namespace vast
         owning_module_ref mod(mlir::parseSourceFile< vast_module >(source_mgr, &ctx));
         ctx.enableMultithreading(wasThreadingEnabled);
         if (!mod) {
-            llvm::errs() << "error: cannot parse module\n";
+            out.diagnostic("cannot parse module");
             return mlir::failure();
         }
 
-        auto process_scope = [&] (auto scope) {
-            if (query::show_symbols()) {
-                return query::do_show_symbols(scope);
+        if (cl::options->build_index) {
+            return write_index(mod.get(), input, out);
+        }
+
+        query::module_source source(mod.get());
+        return query::answer(source, batch, out);
+    }
+
+    logical_result run(
+        mcontext_t &ctx, string_ref input, const std::optional< batch_t > &batch,
+        const printer_t &out
+    ) {
+        std::string err;
+        if (auto buffer = mlir::openInputFile(input, &err))
+            return do_query(ctx, std::move(buffer), input, batch, out);
+        out.diagnostic(err);
+        return mlir::failure();
+    }
+
+    //
+    // Queries many modules on a thread pool. Each module is parsed into its
+    // own context, so that parsing does not contend on the shared uniquers and
+    // the memory of a module is released as soon as it is answered. Results
+    // are buffered per module and printed in the order of inputs.
+    //
+    logical_result run_parallel(
+        const mlir::DialectRegistry &registry, const std::vector< std::string > &inputs,
+        const std::optional< batch_t > &batch
+    ) {
+        struct module_result {
+            std::string out;
+            std::string err;
+            logical_result status = mlir::success();
+        };
+
+        std::vector< module_result > results(inputs.size());
+        std::vector< std::shared_future< void > > tasks;
+        tasks.reserve(inputs.size());
+
+        llvm::ThreadPool pool(llvm::hardware_concurrency(cl::options->jobs));
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            tasks.push_back(pool.async([&, i] {
+                auto &result = results[i];
+                llvm::raw_string_ostream os(result.out);
+                llvm::raw_string_ostream es(result.err);
+
+                mcontext_t ctx(registry, mcontext_t::Threading::DISABLED);
+
+                printer_t out{ .module = inputs[i], .os = &os, .es = &es };
+                result.status = run(ctx, inputs[i], batch, out);
+            }));
+        }
+
+        auto status = mlir::success();
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            tasks[i].wait();
+
+            auto &result = results[i];
+            llvm::outs() << result.out;
+            llvm::errs() << result.err;
+            llvm::outs().flush();
+
+            if (failed(result.status)) {
+                status = mlir::failure();
             }
 
-            if (query::show_symbol_users()) {
-                return query::do_show_users(scope);
+            result = {};
+        }
+
+        return status;
+    }
+
+    std::optional< std::vector< std::string > > input_files(const printer_t &out) {
+        std::vector< std::string > inputs(
+            cl::options->input_files.begin(), cl::options->input_files.end()
+        );
+
+        string_ref list = cl::options->input_list;
+        if (!list.empty()) {
+            auto listed = query::read_lines(list, out);
+            if (!listed) {
+                return std::nullopt;
             }
 
-            return mlir::success();
-        };
+            inputs.insert(inputs.end(), listed->begin(), listed->end());
+        }
 
-        mlir::Operation *scope = mod.get();
-        if (query::constrained_scope()) {
-            return get_scope_operation(scope, cl::options->scope_name, process_scope);
-        } else {
-            return process_scope(scope);
+        if (inputs.empty() && list.empty()) {
+            inputs.push_back("-");
         }
+
+        return inputs;
     }
 
-    logical_result run(mcontext_t &ctx) {
-        std::string err;
-        if (auto input = mlir::openInputFile(cl::options->input_file, &err))
-            return do_query(ctx, std::move(input));
-        llvm::errs() << "error: " << err << "\n";
-        return mlir::failure();
+    logical_result run(const mlir::DialectRegistry &registry) {
+        printer_t out;
+
+        auto inputs = input_files(out);
+        if (!inputs) {
+            return mlir::failure();
+        }
+
+        std::optional< batch_t > batch;
+        string_ref batch_file = cl::options->batch_file;
+        if (!batch_file.empty()) {
+            batch = query::read_lines(batch_file, out);
+            if (!batch) {
+                return mlir::failure();
+            }
+        }
+
+        if (inputs->size() != 1) {
+            if (cl::options->build_index && !cl::options->output_file.empty()) {
+                out.diagnostic("-o cannot be used with multiple inputs");
+                return mlir::failure();
+            }
+
+            return run_parallel(registry, *inputs, batch);
+        }
+
+        // Dialects are loaded by the parser as it encounters them.
+        mcontext_t ctx(registry);
+
+        return run(ctx, inputs->front(), batch, out);
     }
 
 } // namespace vast
@@ -223,8 +893,5 @@ int main(int argc, char **argv) {
     vast::registerAllDialects(registry);
     mlir::registerAllDialects(registry);
 
-    vast::mcontext_t ctx(registry);
-    ctx.loadAllAvailableDialects();
-
-    std::exit(failed(vast::run(ctx)));
+    std::exit(failed(vast::run(registry)));
 }
@@ -28,7 +28,11 @@ namespace vast::repl::codegen {
 
     owning_module_ref emit_module(const std::string &source, mcontext_t *mctx) {
         auto unit = codegen::ast_from_source(source);
-        auto &actx = unit->getASTContext();
+        return emit_module(*unit, mctx);
+    }
+
+    owning_module_ref emit_module(clang::ASTUnit &unit, mcontext_t *mctx) {
+        auto &actx = unit.getASTContext();
         // TODO use front codegen enstead of custom pipeline
         vast::cg::codegen_context cgctx( *mctx, actx, cg::source_language::C );
         vast::cg::default_codegen codegen(cgctx);
@@ -2,30 +2,101 @@
 
 #include "vast/repl/command.hpp"
 
+VAST_RELAX_WARNINGS
+#include <mlir/Dialect/LLVMIR/LLVMDialect.h>
+#include <mlir/ExecutionEngine/ExecutionEngine.h>
+
+#include <llvm/Support/Error.h>
+#include <llvm/Support/FileSystem.h>
+VAST_UNRELAX_WARNINGS
+
 #include "vast/Conversion/Passes.hpp"
+#include "vast/Target/LLVMIR/Convert.hpp"
 #include "vast/Tower/Tower.hpp"
 #include "vast/repl/common.hpp"
 #include <optional>
 
 namespace vast::repl::cmd {
 
+    // Drops everything derived from the loaded source or module.
+    void invalidate(state_t &state) {
+        state.jit_cache.clear();
+        state.tower.reset();
+        state.unit.reset();
+    }
+
+    llvm::sys::TimePoint<> modification_time(const std::filesystem::path &path) {
+        llvm::sys::fs::file_status status;
+        if (llvm::sys::fs::status(path.string(), status)) {
+            return {};
+        }
+        return status.getLastModificationTime();
+    }
+
+    // Rereads the source if its file was modified since it was loaded. The
+    // cached AST and module are dropped only if the contents differ, touching
+    // the file keeps them.
+    void refresh_source(state_t &state) {
+        if (!state.stamp) {
+            return;
+        }
+
+        auto &stamp = *state.stamp;
+        auto mtime = modification_time(stamp.path);
+        if (mtime == stamp.mtime) {
+            return;
+        }
+
+        stamp.mtime = mtime;
+        auto source = codegen::get_source(stamp.path);
+        auto hash   = llvm::hash_value(source);
+        if (hash == stamp.hash) {
+            return;
+        }
+
+        stamp.hash   = hash;
+        state.source = std::move(source);
+        invalidate(state);
+    }
+
     void check_source(const state_t &state) {
         if (!state.source.has_value()) {
             VAST_UNREACHABLE("error: missing source");
         }
     }
 
-    const std::string &get_source(const state_t &state) {
+    const std::string &get_source(state_t &state) {
+        refresh_source(state);
         check_source(state);
         return state.source.value();
     }
 
+    clang::ASTUnit &get_unit(state_t &state) {
+        const auto &source = get_source(state);
+        if (!state.unit) {
+            state.unit = codegen::ast_from_source(source);
+        }
+        return *state.unit;
+    }
+
+    owning_module_ref load_bytecode_module(state_t &state) {
+        auto mod = state.bytecode->release();
+        if (!mod) {
+            VAST_UNREACHABLE("error: failed to read module");
+        }
+
+        state.bytecode.reset();
+        return mod;
+    }
+
     void check_and_emit_module(state_t &state) {
+        refresh_source(state);
         if (!state.tower) {
-            const auto &source = get_source(state);
-            auto mod           = codegen::emit_module(source, &state.ctx);
-            auto [t, _]        = tw::default_tower::get(state.ctx, std::move(mod));
-            state.tower        = std::move(t);
+            auto mod = state.bytecode
+                ? load_bytecode_module(state)
+                : codegen::emit_module(get_unit(state), &state.ctx);
+            auto [t, _] = tw::default_tower::get(state.ctx, std::move(mod));
+            state.tower = std::move(t);
         }
     }
 
@@ -47,20 +118,40 @@ namespace vast::repl::cmd {
     // load command
     //
     void load::run(state_t &state) const {
-        auto source  = get_param< source_param >(params);
+        auto source = get_param< source_param >(params);
+
+        invalidate(state);
+        state.source.reset();
+        state.stamp.reset();
+        state.bytecode.reset();
+
+        auto buffer = llvm::MemoryBuffer::getFile(source.path.string());
+        if (buffer && util::is_bytecode(**buffer)) {
+            state.bytecode = util::lazy_module::read(std::move(*buffer), &state.ctx);
+            if (!state.bytecode) {
+                VAST_UNREACHABLE("error: failed to read module {0}", source.path.string());
+            }
+            return;
+        }
+
+        // The stamp is taken before reading, so that a write racing with
+        // the load is picked up by the next command.
+        auto mtime = modification_time(source.path);
         state.source = codegen::get_source(source.path);
+        state.stamp  = state_t::source_stamp{
+            source.path, mtime, llvm::hash_value(*state.source)
+        };
     };
 
     //
     // show command
     //
-    void show_source(const state_t &state) {
+    void show_source(state_t &state) {
         llvm::outs() << get_source(state) << "\n";
     }
 
-    void show_ast(const state_t &state) {
-        auto unit = codegen::ast_from_source(get_source(state));
-        unit->getASTContext().getTranslationUnitDecl()->dump(llvm::outs());
+    void show_ast(state_t &state) {
+        get_unit(state).getASTContext().getTranslationUnitDecl()->dump(llvm::outs());
         llvm::outs() << "\n";
     }
 
@@ -141,4 +232,142 @@ namespace vast::repl::cmd {
         }
     }
 
+    //
+    // run command
+    //
+    state_t::jit_layer &get_or_compile(state_t &state) {
+        check_and_emit_module(state);
+
+        auto top = state.tower->top();
+        auto &layer = state.jit_cache[top.id];
+        if (layer.engine)
+            return layer;
+
+        // Lowering is destructive, therefore the tower layer is left intact
+        // and a copy of it gets compiled.
+        layer.mod = owning_module_ref(mlir::cast< vast_module >(top.mod->clone()));
+        target::llvmir::lower_hl_module(layer.mod.get());
+
+        auto build_llvm_module = [] (operation op, llvm::LLVMContext &llvm_ctx) {
+            return target::llvmir::translate(mlir::cast< vast_module >(op), llvm_ctx);
+        };
+
+        mlir::ExecutionEngineOptions opts;
+        opts.llvmModuleBuilder = build_llvm_module;
+
+        auto engine = mlir::ExecutionEngine::create(layer.mod.get(), opts);
+        if (!engine) {
+            auto msg = llvm::toString(engine.takeError());
+            state.jit_cache.erase(top.id);
+            VAST_UNREACHABLE("error: failed to compile module: {0}", msg);
+        }
+
+        layer.engine = std::move(engine.get());
+        return layer;
+    }
+
+    union scalar_storage {
+        std::int8_t  i8;
+        std::int16_t i16;
+        std::int32_t i32;
+        std::int64_t i64;
+        float        f32;
+        double       f64;
+    };
+
+    void *pack_argument(scalar_storage &storage, mlir_type type, string_ref token) {
+        if (auto int_type = mlir::dyn_cast< mlir::IntegerType >(type)) {
+            std::int64_t value = 0;
+            if (token.getAsInteger(0, value)) {
+                VAST_UNREACHABLE("error: expected integer argument, got: {0}", token);
+            }
+
+            switch (int_type.getWidth()) {
+                case 1:
+                case 8:  storage.i8  = static_cast< std::int8_t >(value);  return &storage.i8;
+                case 16: storage.i16 = static_cast< std::int16_t >(value); return &storage.i16;
+                case 32: storage.i32 = static_cast< std::int32_t >(value); return &storage.i32;
+                case 64: storage.i64 = value; return &storage.i64;
+                default: break;
+            }
+        }
+
+        if (type.isF32() || type.isF64()) {
+            double value = 0;
+            if (token.getAsDouble(value)) {
+                VAST_UNREACHABLE("error: expected floating point argument, got: {0}", token);
+            }
+
+            if (type.isF32()) {
+                storage.f32 = static_cast< float >(value);
+                return &storage.f32;
+            }
+
+            storage.f64 = value;
+            return &storage.f64;
+        }
+
+        VAST_UNREACHABLE("error: unsupported argument type: {0}", type);
+    }
+
+    void print_result(const scalar_storage &storage, mlir_type type) {
+        if (auto int_type = mlir::dyn_cast< mlir::IntegerType >(type)) {
+            switch (int_type.getWidth()) {
+                case 1:  llvm::outs() << (storage.i8 & 1); break;
+                case 8:  llvm::outs() << std::int64_t(storage.i8);  break;
+                case 16: llvm::outs() << std::int64_t(storage.i16); break;
+                case 32: llvm::outs() << std::int64_t(storage.i32); break;
+                case 64: llvm::outs() << storage.i64; break;
+                default: VAST_UNREACHABLE("error: unsupported result type: {0}", type);
+            }
+        } else if (type.isF32()) {
+            llvm::outs() << storage.f32;
+        } else if (type.isF64()) {
+            llvm::outs() << storage.f64;
+        } else {
+            VAST_UNREACHABLE("error: unsupported result type: {0}", type);
+        }
+
+        llvm::outs() << "\n";
+    }
+
+    void run_function::run(state_t &state) const {
+        auto &layer = get_or_compile(state);
+
+        auto name = get_param< function_param >(params).value;
+        auto args = get_param< arguments_param >(params).values;
+
+        auto fn = layer.mod->lookupSymbol< mlir::LLVM::LLVMFuncOp >(name);
+        if (!fn || fn.isExternal()) {
+            VAST_UNREACHABLE("error: unknown function: {0}", name);
+        }
+
+        auto fty = fn.getFunctionType();
+        if (fty.getNumParams() != args.size() || fty.isVarArg()) {
+            VAST_UNREACHABLE("error: function {0} expects {1} arguments",
+                name, fty.getNumParams()
+            );
+        }
+
+        std::vector< scalar_storage > storage(args.size() + 1);
+        std::vector< void * > packed;
+        for (auto [idx, arg] : llvm::enumerate(args)) {
+            packed.push_back(pack_argument(storage[idx], fty.getParamType(idx), arg));
+        }
+
+        auto rty = fty.getReturnType();
+        bool returns_void = mlir::isa< mlir::LLVM::LLVMVoidType >(rty);
+        if (!returns_void) {
+            packed.push_back(&storage.back());
+        }
+
+        if (auto err = layer.engine->invokePacked(name, packed)) {
+            VAST_UNREACHABLE("error: failed to run {0}: {1}", name, llvm::toString(std::move(err)));
+        }
+
+        if (!returns_void) {
+            print_result(storage.back(), rty);
+        }
+    }
+
 } // namespace vast::repl::cmd
@@ -12,12 +12,14 @@ VAST_RELAX_WARNINGS
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Tools/mlir-opt/MlirOptMain.h"
 #include "mlir/Target/LLVMIR/Dialect/All.h"
+#include "llvm/Support/TargetSelect.h"
 #include "vast/repl/linenoise.hpp"
 VAST_UNRELAX_WARNINGS
 
 #include "vast/Dialect/Dialects.hpp"
 #include "vast/Dialect/HighLevel/Passes.hpp"
 #include "vast/Conversion/Passes.hpp"
+#include "vast/Target/LLVMIR/Convert.hpp"
 #include "vast/Util/Common.hpp"
 #include "vast/repl/cli.hpp"
 #include "vast/repl/command.hpp"
@@ -91,11 +93,16 @@ int main(int argc, char **argv) try {
 
     // register conversions
     mlir::registerAllToLLVMIRTranslations(registry);
+    vast::target::llvmir::register_vast_to_llvm_ir(registry);
+
+    // required by the `run` command to jit compile modules
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
 
     args_t args = load_args(argc, argv);
 
+    // Dialects are loaded on demand by the parser, codegen and passes.
     vast::mcontext_t ctx(registry);
-    ctx.loadAllAvailableDialects();
 
     auto prompt = vast::repl::prompt(ctx);
 